@@ -0,0 +1,80 @@
+#include "BatchGenerator.h"
+#include <ostream>
+#include <thread>
+#include "PuzzleCorpus.h"
+#include "TurnPuzzle.h"
+
+BatchGenerator::BatchGenerator(const BatchSettings& settings)
+    : settings(settings), nextIndex(0) {
+}
+
+std::vector<BatchResult> BatchGenerator::run() {
+    results.assign(settings.puzzleCount > 0 ? settings.puzzleCount : 0, BatchResult());
+    nextIndex = 0;
+
+    int threadCount = settings.threads < 1 ? 1 : settings.threads;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&BatchGenerator::workerLoop, this);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return results;
+}
+
+uint32_t BatchGenerator::puzzleSeed(uint32_t firstSeed, int index) {
+    // SplitMix64 step: neighbouring indices get unrelated seeds
+    uint64_t z = (static_cast<uint64_t>(firstSeed) << 32) + static_cast<uint64_t>(index) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<uint32_t>(z ^ (z >> 31));
+}
+
+void BatchGenerator::workerLoop() {
+    // Every slot of results is written by exactly one thread
+    while (true) {
+        int index = nextIndex++;
+        if (index >= static_cast<int>(results.size())) {
+            return;
+        }
+        results[index] = generate(index);
+    }
+}
+
+BatchResult BatchGenerator::generate(int index) const {
+    BatchResult result;
+    result.index = index;
+    result.seed = puzzleSeed(settings.firstSeed, index);
+    result.filePrefix = settings.filePrefix + "puzzle-" + std::to_string(result.seed) + "-";
+
+    // Progress messages of batch puzzles are dropped; a stream without a buffer discards its output
+    std::ostream discard(nullptr);
+    TurnPuzzle puzzle(settings.gridSize, result.filePrefix, discard);
+    puzzle.setSeed(result.seed);
+    puzzle.setBranchStrategy(settings.branchStrategy);
+    puzzle.setIncrementalSearch(settings.incrementalSearch);
+    puzzle.setSolverEngine(settings.solverEngine);
+    puzzle.setTranspositionMemory(settings.transpositionMegabytes);
+    puzzle.setProbeBudget(settings.probeBudget);
+    puzzle.setSolutionCounting(settings.solutionCounting);
+
+    // The steps of GeneratePuzzle, stopping before the search if the solution is unusable
+    result.walls = 0;
+    result.searchNodes = 0;
+    puzzle.generateSolution();
+    puzzle.markCells();
+    puzzle.exportToSVG(result.filePrefix + "solution.svg");
+    result.covered = puzzle.isSolutionCovered();
+    if (!result.covered) {
+        return result;
+    }
+    puzzle.solvePuzzle();
+    puzzle.exportProblem();
+
+    result.walls = puzzle.getWallCount();
+    result.searchNodes = puzzle.getSearchNodes();
+    PuzzleCorpus::pack(puzzle, result.record);
+    return result;
+}
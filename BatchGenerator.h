@@ -0,0 +1,60 @@
+#ifndef BATCHGENERATOR_H
+#define BATCHGENERATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DataTypes.h"
+
+// Settings shared by every puzzle of a batch
+struct BatchSettings {
+    int puzzleCount = 1;
+    int gridSize = 6;
+    int threads = 1;  // Puzzles generated at once; each puzzle is searched on one thread
+    uint32_t firstSeed = 1;  // Start of the seed stream, see BatchGenerator::puzzleSeed
+    std::string filePrefix;  // Put in front of every puzzle's "puzzle-<seed>-" file names
+    TurnPuzzleTypes::BranchStrategy branchStrategy = TurnPuzzleTypes::BranchStrategy::FIRST_UNDECIDED;
+    bool incrementalSearch = false;
+    TurnPuzzleTypes::SolverEngine solverEngine = TurnPuzzleTypes::SolverEngine::OBJECT_GRAPH;
+    size_t transpositionMegabytes = 16;
+    int probeBudget = 0;
+    bool solutionCounting = false;
+};
+
+// Outcome of one generate, mark and uniqueness pipeline
+struct BatchResult {
+    int index;
+    uint32_t seed;
+    std::string filePrefix;  // debug.log, solution.svg and problem.svg of the puzzle start with this
+    bool covered;  // False if the generated solution leaves cells off every HEAD path; such a puzzle has
+                   // no solution, so it is neither verified nor packed
+    int walls;  // Walls needed to make the solution unique
+    long long searchNodes;
+    std::vector<unsigned char> record;  // The finished puzzle, packed by PuzzleCorpus::pack
+};
+
+// Generates many independent puzzles on a pool of threads.
+// Puzzle i is seeded with puzzleSeed(firstSeed, i) and writes only its own files, so a batch gives
+// the same puzzles whatever the thread count and the order the threads finish in. Puzzles whose
+// solution is not covered by HEAD paths are skipped and reported in their result.
+class BatchGenerator {
+public:
+    explicit BatchGenerator(const BatchSettings& settings);
+
+    // Results are in puzzle order
+    std::vector<BatchResult> run();
+
+    static uint32_t puzzleSeed(uint32_t firstSeed, int index);
+
+private:
+    BatchSettings settings;
+    std::atomic<int> nextIndex;  // Next puzzle a thread takes
+    std::vector<BatchResult> results;
+
+    void workerLoop();
+    BatchResult generate(int index) const;
+};
+
+#endif // BATCHGENERATOR_H
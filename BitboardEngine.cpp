@@ -0,0 +1,475 @@
+#include "BitboardEngine.h"
+#include <algorithm>
+#include "TurnPuzzle.h"
+
+namespace {
+
+// Cells of a row with at least one, two and three of the four edge masks set
+struct DegreeBits {
+    uint64_t atLeast1;
+    uint64_t atLeast2;
+    uint64_t atLeast3;
+};
+
+// Bit-sliced sum of four one-bit counters per cell
+DegreeBits countBits(uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
+    uint64_t abSum = a ^ b;
+    uint64_t abCarry = a & b;
+    uint64_t cdSum = c ^ d;
+    uint64_t cdCarry = c & d;
+    uint64_t ones = abSum ^ cdSum;
+    uint64_t carry = abSum & cdSum;
+    uint64_t twos = abCarry ^ cdCarry ^ carry;
+    uint64_t fours = (abCarry & cdCarry) | (carry & (abCarry ^ cdCarry));
+
+    DegreeBits bits;
+    bits.atLeast1 = ones | twos | fours;
+    bits.atLeast2 = twos | fours;
+    bits.atLeast3 = fours | (twos & ones);
+    return bits;
+}
+
+uint64_t lowBits(int count) {
+    return count >= 64 ? ~0ULL : (1ULL << count) - 1;
+}
+
+bool testBit(uint64_t word, int bit) {
+    return (word >> bit) & 1;
+}
+
+TurnPuzzleTypes::Direction directionBetween(int from, int to, int gridSize) {
+    if (to == from - gridSize) return TurnPuzzleTypes::UP;
+    if (to == from + gridSize) return TurnPuzzleTypes::DOWN;
+    if (to == from - 1) return TurnPuzzleTypes::LEFT;
+    return TurnPuzzleTypes::RIGHT;
+}
+
+} // namespace
+
+BitboardEngine::BitboardEngine(const TurnPuzzle& puzzle)
+    : gridSize(puzzle.gridSize), cellMask(lowBits(puzzle.gridSize)), edgeMaskH(lowBits(puzzle.gridSize - 1)),
+      headRows(), deletedH(), deletedV(), originalH(), originalV(), root(), solution(), searchNodes(0) {
+    for (const Cell* cell : puzzle.cells) {
+        if (cell->cellType == HEAD) {
+            headRows[cell->row] |= 1ULL << cell->col;
+        }
+    }
+
+    // Edges are horizontal rows first, then vertical rows, as in TurnPuzzle::initializeEdges
+    const int horizontalCount = gridSize * (gridSize - 1);
+    for (const Edge* edge : puzzle.edges) {
+        bool horizontal = edge->id < horizontalCount;
+        int row = edge->cell1->row;
+        uint64_t bit = 1ULL << edge->cell1->col;
+        Rows& deleted = horizontal ? deletedH : deletedV;
+        Rows& included = horizontal ? root.includedH : root.includedV;
+        Rows& excluded = horizontal ? root.excludedH : root.excludedV;
+        Rows& original = horizontal ? originalH : originalV;
+
+        switch (edge->state) {
+            case DELETED:  deleted[row] |= bit; break;
+            case INCLUDED: included[row] |= bit; break;
+            case EXCLUDED: excluded[row] |= bit; break;
+            case UNDECIDED: break;
+        }
+        if (puzzle.originalSolution[edge->id] == INCLUDED) {
+            original[row] |= bit;
+        }
+    }
+
+    ends.resize(gridSize * gridSize);
+    visited.resize(gridSize * gridSize);
+}
+
+int BitboardEngine::run() {
+    searchNodes = 0;
+    pending.assign(1, root);
+    return search();
+}
+
+long long BitboardEngine::getSearchNodes() const {
+    return searchNodes;
+}
+
+void BitboardEngine::copySolutionTo(TurnPuzzle& puzzle) const {
+    const int horizontalCount = gridSize * (gridSize - 1);
+    for (Edge* edge : puzzle.edges) {
+        if (edge->isDeleted()) {
+            continue;
+        }
+        bool horizontal = edge->id < horizontalCount;
+        int row = edge->cell1->row;
+        int col = edge->cell1->col;
+        const Rows& included = horizontal ? solution.includedH : solution.includedV;
+        const Rows& excluded = horizontal ? solution.excludedH : solution.excludedV;
+
+        if (testBit(included[row], col)) {
+            edge->setState(INCLUDED);
+        } else if (testBit(excluded[row], col)) {
+            edge->setState(EXCLUDED);
+        } else {
+            edge->setState(UNDECIDED);
+        }
+    }
+}
+
+uint64_t BitboardEngine::undecidedH(const State& state, int row) const {
+    return edgeMaskH & ~(state.includedH[row] | state.excludedH[row] | deletedH[row]);
+}
+
+uint64_t BitboardEngine::undecidedV(const State& state, int row) const {
+    if (row < 0 || row >= gridSize - 1) {
+        return 0;
+    }
+    return cellMask & ~(state.includedV[row] | state.excludedV[row] | deletedV[row]);
+}
+
+bool BitboardEngine::isHead(int cell) const {
+    return testBit(headRows[cell / gridSize], cell % gridSize);
+}
+
+int BitboardEngine::nextOnPath(const State& state, int cell, int previous) const {
+    int row = cell / gridSize;
+    int col = cell % gridSize;
+
+    if (testBit(state.includedH[row], col) && cell + 1 != previous) {
+        return cell + 1;
+    }
+    if (col > 0 && testBit(state.includedH[row], col - 1) && cell - 1 != previous) {
+        return cell - 1;
+    }
+    if (row < gridSize - 1 && testBit(state.includedV[row], col) && cell + gridSize != previous) {
+        return cell + gridSize;
+    }
+    if (row > 0 && testBit(state.includedV[row - 1], col) && cell - gridSize != previous) {
+        return cell - gridSize;
+    }
+    return -1;
+}
+
+bool BitboardEngine::propagate(State& state) {
+    while (true) {
+        if (!propagateDegrees(state)) {
+            return false;
+        }
+
+        bool changed = false;
+        if (!checkPaths(state, changed)) {
+            return false;
+        }
+        if (!changed) {
+            return true;
+        }
+    }
+}
+
+bool BitboardEngine::propagateDegrees(State& state) const {
+    while (true) {
+        Rows includeH = {};
+        Rows includeV = {};
+        Rows excludeH = {};
+        Rows excludeV = {};
+
+        for (int row = 0; row < gridSize; row++) {
+            uint64_t up = row > 0 ? state.includedV[row - 1] : 0;
+            uint64_t down = row < gridSize - 1 ? state.includedV[row] : 0;
+            DegreeBits degree = countBits(state.includedH[row], state.includedH[row] << 1, down, up);
+
+            uint64_t openH = undecidedH(state, row);
+            uint64_t openDown = undecidedV(state, row);
+            uint64_t openUp = undecidedV(state, row - 1);
+            DegreeBits available = countBits(openH, openH << 1, openDown, openUp);
+
+            // HEAD cells take one edge, UNMARKED cells two
+            uint64_t head = headRows[row];
+            if ((head & degree.atLeast2) | degree.atLeast3) {
+                return false;
+            }
+
+            // Every cell is on a path, so a cell without edges needs an undecided one
+            uint64_t empty = cellMask & ~degree.atLeast1;
+            if (empty & ~available.atLeast1) {
+                return false;
+            }
+
+            // Full cells exclude their remaining edges; empty cells with one option include it
+            uint64_t full = (head & degree.atLeast1) | degree.atLeast2;
+            uint64_t forced = empty & available.atLeast1 & ~available.atLeast2;
+
+            excludeH[row] |= (full | (full >> 1)) & openH;
+            includeH[row] |= (forced | (forced >> 1)) & openH;
+            if (row < gridSize - 1) {
+                excludeV[row] |= full & openDown;
+                includeV[row] |= forced & openDown;
+            }
+            if (row > 0) {
+                excludeV[row - 1] |= full & openUp;
+                includeV[row - 1] |= forced & openUp;
+            }
+        }
+
+        bool changed = false;
+        for (int row = 0; row < gridSize; row++) {
+            // One end needs the edge while the other end is full
+            if ((includeH[row] & excludeH[row]) | (includeV[row] & excludeV[row])) {
+                return false;
+            }
+            state.includedH[row] |= includeH[row];
+            state.includedV[row] |= includeV[row];
+            state.excludedH[row] |= excludeH[row];
+            state.excludedV[row] |= excludeV[row];
+            changed = changed || (includeH[row] | includeV[row] | excludeH[row] | excludeV[row]) != 0;
+        }
+
+        if (!changed) {
+            return true;
+        }
+    }
+}
+
+bool BitboardEngine::checkPaths(State& state, bool& changed) {
+    std::fill(visited.begin(), visited.end(), 0);
+
+    // Trace every open path once, from the end found first
+    for (int row = 0; row < gridSize; row++) {
+        uint64_t up = row > 0 ? state.includedV[row - 1] : 0;
+        uint64_t down = row < gridSize - 1 ? state.includedV[row] : 0;
+        DegreeBits degree = countBits(state.includedH[row], state.includedH[row] << 1, down, up);
+
+        for (uint64_t bits = cellMask & ~degree.atLeast2; bits != 0; bits &= bits - 1) {
+            int start = row * gridSize + __builtin_ctzll(bits);
+            if (visited[start]) {
+                continue;
+            }
+            visited[start] = 1;
+
+            TurnSignature signature;
+            int previous = -1;
+            int end = start;
+            while (true) {
+                int next = nextOnPath(state, end, previous);
+                if (next < 0) {
+                    break;
+                }
+                signature.addStep(directionBetween(end, next, gridSize));
+                visited[next] = 1;
+                previous = end;
+                end = next;
+            }
+
+            // A path may not run from one HEAD to another or turn both ways
+            if (end != start && isHead(start) && isHead(end)) {
+                return false;
+            }
+            if (signature.getTurnType() == RIGHT_LEFT_MIXED) {
+                return false;
+            }
+
+            bool hasHead = isHead(start) || isHead(end);
+            ends[start] = {end, signature, hasHead};
+            ends[end] = {start, signature.reversed(), hasHead};
+        }
+    }
+
+    // Cells with edges that no open path reached lie on a closed loop
+    for (int row = 0; row < gridSize; row++) {
+        uint64_t up = row > 0 ? state.includedV[row - 1] : 0;
+        uint64_t down = row < gridSize - 1 ? state.includedV[row] : 0;
+        uint64_t connected = state.includedH[row] | (state.includedH[row] << 1) | down | up;
+        for (uint64_t bits = connected & cellMask; bits != 0; bits &= bits - 1) {
+            if (!visited[row * gridSize + __builtin_ctzll(bits)]) {
+                return false;
+            }
+        }
+    }
+
+    // An undecided edge between two open ends is excluded when joining their paths would
+    // close a loop, connect two HEADs or mix turn directions
+    for (int row = 0; row < gridSize; row++) {
+        uint64_t openH = undecidedH(state, row);
+        for (uint64_t bits = openH; bits != 0; bits &= bits - 1) {
+            int col = __builtin_ctzll(bits);
+            int from = row * gridSize + col;
+            const PathEnd& first = ends[from];
+            const PathEnd& second = ends[from + 1];
+            // Full cells were handled by propagateDegrees, so both cells are open ends here
+            if (first.farEnd == from + 1 || (first.hasHead && second.hasHead) ||
+                TurnSignature::join(first.signature.reversed(), TurnPuzzleTypes::RIGHT,
+                                    second.signature).getTurnType() == RIGHT_LEFT_MIXED) {
+                state.excludedH[row] |= 1ULL << col;
+                changed = true;
+            }
+        }
+
+        uint64_t openV = undecidedV(state, row);
+        for (uint64_t bits = openV; bits != 0; bits &= bits - 1) {
+            int col = __builtin_ctzll(bits);
+            int from = row * gridSize + col;
+            const PathEnd& first = ends[from];
+            const PathEnd& second = ends[from + gridSize];
+            if (first.farEnd == from + gridSize || (first.hasHead && second.hasHead) ||
+                TurnSignature::join(first.signature.reversed(), TurnPuzzleTypes::DOWN,
+                                    second.signature).getTurnType() == RIGHT_LEFT_MIXED) {
+                state.excludedV[row] |= 1ULL << col;
+                changed = true;
+            }
+        }
+    }
+
+    // If the far end of an open UNMARKED end cannot grow it is the tail, so this end has
+    // to continue towards a HEAD
+    for (int row = 0; row < gridSize; row++) {
+        uint64_t up = row > 0 ? state.includedV[row - 1] : 0;
+        uint64_t down = row < gridSize - 1 ? state.includedV[row] : 0;
+        DegreeBits degree = countBits(state.includedH[row], state.includedH[row] << 1, down, up);
+
+        for (uint64_t bits = degree.atLeast1 & ~degree.atLeast2 & ~headRows[row]; bits != 0; bits &= bits - 1) {
+            int cell = row * gridSize + __builtin_ctzll(bits);
+            const PathEnd& end = ends[cell];
+            int farNeighbors[4];
+            if (end.hasHead || undecidedNeighbors(state, end.farEnd, farNeighbors) > 0) {
+                continue;
+            }
+
+            int neighbors[4];
+            int count = undecidedNeighbors(state, cell, neighbors);
+            if (count == 0) {
+                return false;
+            }
+            if (count == 1) {
+                // The new edge joins two paths, so the traced ends are out of date
+                includeEdge(state, cell, neighbors[0]);
+                changed = true;
+                return true;
+            }
+        }
+    }
+
+    return true;
+}
+
+int BitboardEngine::undecidedNeighbors(const State& state, int cell, int neighbors[4]) const {
+    int row = cell / gridSize;
+    int col = cell % gridSize;
+    int count = 0;
+
+    if (testBit(undecidedH(state, row), col)) {
+        neighbors[count++] = cell + 1;
+    }
+    if (col > 0 && testBit(undecidedH(state, row), col - 1)) {
+        neighbors[count++] = cell - 1;
+    }
+    if (testBit(undecidedV(state, row), col)) {
+        neighbors[count++] = cell + gridSize;
+    }
+    if (testBit(undecidedV(state, row - 1), col)) {
+        neighbors[count++] = cell - gridSize;
+    }
+    return count;
+}
+
+void BitboardEngine::includeEdge(State& state, int from, int to) const {
+    // Horizontal and vertical edges are stored at their left and top cell
+    int cell = std::min(from, to);
+    int row = cell / gridSize;
+    int col = cell % gridSize;
+    if (std::max(from, to) == cell + 1) {
+        state.includedH[row] |= 1ULL << col;
+    } else {
+        state.includedV[row] |= 1ULL << col;
+    }
+}
+
+bool BitboardEngine::isSolved(const State& state) const {
+    // Every cell needs an edge before it can be on a HEAD path
+    for (int row = 0; row < gridSize; row++) {
+        uint64_t up = row > 0 ? state.includedV[row - 1] : 0;
+        uint64_t down = row < gridSize - 1 ? state.includedV[row] : 0;
+        uint64_t connected = state.includedH[row] | (state.includedH[row] << 1) | down | up;
+        if ((connected & cellMask) != cellMask) {
+            return false;
+        }
+    }
+
+    // Paths are valid after propagate(), so the HEAD paths only have to cover the grid
+    Rows covered = {};
+    for (int row = 0; row < gridSize; row++) {
+        for (uint64_t bits = headRows[row]; bits != 0; bits &= bits - 1) {
+            int previous = -1;
+            int cell = row * gridSize + __builtin_ctzll(bits);
+            while (cell >= 0) {
+                covered[cell / gridSize] |= 1ULL << (cell % gridSize);
+                int next = nextOnPath(state, cell, previous);
+                previous = cell;
+                cell = next;
+            }
+        }
+    }
+
+    int coveredCount = 0;
+    for (int row = 0; row < gridSize; row++) {
+        coveredCount += __builtin_popcountll(covered[row]);
+    }
+    return coveredCount == gridSize * gridSize;
+}
+
+int BitboardEngine::findDifferentEdge(const State& state) const {
+    // Same edge order as TurnPuzzle::FindDifferentEdge
+    for (int row = 0; row < gridSize; row++) {
+        uint64_t extra = state.includedH[row] & ~originalH[row];
+        if (extra != 0) {
+            return row * (gridSize - 1) + __builtin_ctzll(extra);
+        }
+    }
+    for (int row = 0; row < gridSize - 1; row++) {
+        uint64_t extra = state.includedV[row] & ~originalV[row];
+        if (extra != 0) {
+            return gridSize * (gridSize - 1) + row * gridSize + __builtin_ctzll(extra);
+        }
+    }
+    return -1;
+}
+
+int BitboardEngine::search() {
+    // Depth first over an explicit stack: the search can be one level deep per undecided edge,
+    // far more than the call stack holds for the larger grids
+    while (!pending.empty()) {
+        State& state = pending.back();
+        searchNodes++;
+        if (!propagate(state)) {
+            pending.pop_back();
+            continue;
+        }
+
+        if (isSolved(state)) {
+            int diffIndex = findDifferentEdge(state);
+            if (diffIndex != -1) {
+                solution = state;
+                return diffIndex;
+            }
+        }
+
+        // Branch on the first undecided edge in edge order
+        bool horizontal = true;
+        int edgeRow = 0;
+        uint64_t open = 0;
+        for (int row = 0; row < 2 * gridSize - 1 && open == 0; row++) {
+            horizontal = row < gridSize;
+            edgeRow = horizontal ? row : row - gridSize;
+            open = horizontal ? undecidedH(state, edgeRow) : undecidedV(state, edgeRow);
+        }
+        if (open == 0) {
+            pending.pop_back();
+            continue;
+        }
+        uint64_t bit = open & (~open + 1);
+
+        // Each branch gets its own copy of the state, so backtracking needs no undo log. The node's
+        // slot becomes the EXCLUDED branch and the INCLUDED branch goes on top, so it is searched first.
+        size_t node = pending.size() - 1;
+        pending.push_back(pending[node]);
+        (horizontal ? pending[node].excludedH : pending[node].excludedV)[edgeRow] |= bit;
+        (horizontal ? pending[node + 1].includedH : pending[node + 1].includedV)[edgeRow] |= bit;
+    }
+    return -1;
+}
@@ -0,0 +1,78 @@
+#ifndef BITBOARDENGINE_H
+#define BITBOARDENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Path.h"
+
+// Forward declaration
+class TurnPuzzle;
+
+// Bitboard version of FindDifferentSolution.
+// Edge states are packed into one 64-bit word per row: bit c of horizontal row r is the edge
+// (r,c)-(r,c+1), bit c of vertical row r is the edge (r,c)-(r+1,c). Degree rules are applied to
+// a whole row of cells at once with bit-sliced counters, so grids of up to 64x64 are supported.
+// The engine is loaded from a TurnPuzzle and writes the solution it finds back into it.
+class BitboardEngine {
+public:
+    static const int MAX_SIZE = 64;
+
+    explicit BitboardEngine(const TurnPuzzle& puzzle);
+
+    // Returns the differing edge index or -1, searching first undecided edges first like FIRST_UNDECIDED
+    int run();
+    long long getSearchNodes() const;
+
+    // Copy the edge states of the different solution found by run() into the puzzle
+    void copySolutionTo(TurnPuzzle& puzzle) const;
+
+private:
+    typedef std::array<uint64_t, MAX_SIZE> Rows;
+
+    // Search state; DELETED edges never change, so they are kept outside it
+    struct State {
+        Rows includedH;
+        Rows includedV;
+        Rows excludedH;
+        Rows excludedV;
+    };
+
+    // What the path through an open end looks like from that end
+    struct PathEnd {
+        int farEnd;               // Cell index of the other end
+        TurnSignature signature;  // Turns seen when walking from this end to farEnd
+        bool hasHead;             // Either end is a HEAD cell
+    };
+
+    int gridSize;
+    uint64_t cellMask;   // One bit per cell of a row
+    uint64_t edgeMaskH;  // One bit per horizontal edge of a row
+    Rows headRows;
+    Rows deletedH;
+    Rows deletedV;
+    Rows originalH;  // INCLUDED edges of the original solution
+    Rows originalV;
+    State root;
+    State solution;
+    std::vector<State> pending;  // Nodes still to search, the next one last
+    long long searchNodes;
+    std::vector<PathEnd> ends;  // Scratch space for checkPaths, indexed by cell
+    std::vector<char> visited;
+
+    uint64_t undecidedH(const State& state, int row) const;
+    uint64_t undecidedV(const State& state, int row) const;
+    bool isHead(int cell) const;
+    int nextOnPath(const State& state, int cell, int previous) const;
+    int undecidedNeighbors(const State& state, int cell, int neighbors[4]) const;  // Returns the count
+    void includeEdge(State& state, int from, int to) const;
+
+    bool propagate(State& state);
+    bool propagateDegrees(State& state) const;
+    bool checkPaths(State& state, bool& changed);  // Path validity plus loop, HEAD and turn exclusions
+    bool isSolved(const State& state) const;
+    int findDifferentEdge(const State& state) const;
+    int search();  // Searches the nodes in pending
+};
+
+#endif // BITBOARDENGINE_H
@@ -0,0 +1,100 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for any number of producers and consumers.
+// Each slot carries a sequence number that says whether it is free for the push or the pop of a
+// given round, so a push or pop claims its position with a single compare-and-swap and never
+// waits on a lock. The capacity is rounded up to a power of two.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t minimumCapacity)
+        : capacity(roundUp(minimumCapacity)), mask(capacity - 1), slots(new Slot[capacity]),
+          pushPosition(0), popPosition(0) {
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // False if the queue is full; the value is only moved from on success
+    bool tryPush(T& value) {
+        size_t position = pushPosition.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position) {
+                return false;  // The slot still holds the value of the previous round
+            } else {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False if the queue is empty
+    bool tryPop(T& value) {
+        size_t position = popPosition.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position + 1) {
+                if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(position + capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position + 1) {
+                return false;  // Nothing pushed into this slot yet
+            } else {
+                position = popPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Values pushed and not yet popped; only a snapshot while other threads are running
+    size_t size() const {
+        size_t pushed = pushPosition.load(std::memory_order_relaxed);
+        size_t popped = popPosition.load(std::memory_order_relaxed);
+        return pushed > popped ? pushed - popped : 0;
+    }
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    // On separate cache lines so producers and consumers do not slow each other down
+    alignas(64) std::atomic<size_t> pushPosition;
+    alignas(64) std::atomic<size_t> popPosition;
+
+    static size_t roundUp(size_t minimum) {
+        size_t size = 1;
+        while (size < minimum) {
+            size <<= 1;
+        }
+        return size;
+    }
+};
+
+#endif // BOUNDEDQUEUE_H
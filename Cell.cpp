@@ -1,11 +1,8 @@
 #include "Cell.h"
 #include "Edge.h"
+#include "Path.h"
 
-// Initialize static counter
-int Cell::idCounter = 0;
-
-Cell::Cell(int r, int c) : row(r), col(c), degree(0), visited(false), cellType(UNMARKED) {
-    id = idCounter++;
+Cell::Cell(int r, int c, int index) : degree(0), id(index), row(r), col(c), visitStamp(0), cellType(UNMARKED) {
 }
 
 void Cell::addEdge(Edge* edge) {
@@ -36,17 +33,12 @@ TurnPuzzleTypes::SolveOutput Cell::Solve() {
             return TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED;
         }
         
-        // More than one undecided edge - no change yet
-        return TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+        // More than one undecided edge - only the turn rule can decide anything
+        return SolveTurns();
     }
     
     // Determine maximum allowed degree based on cell type
-    int maxDegree;
-    if (cellType == HEAD) {
-        maxDegree = 1;
-    } else { // UNMARKED
-        maxDegree = 2;
-    }
+    int maxDegree = getMaxDegree();
     
     // Check if degree exceeds limit (FAIL condition)
     if (degree > maxDegree) {
@@ -66,8 +58,111 @@ TurnPuzzleTypes::SolveOutput Cell::Solve() {
                        : TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
     }
     
+    // This cell is an open path end
+    return SolveTurns();
+}
+
+TurnPuzzleTypes::SolveOutput Cell::SolveTurns() {
+    TurnSignature ownSignature;
+    Cell* farEnd = tracePath(ownSignature);
+    if (farEnd == nullptr) {
+        return TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+    }
+    
+    // Turns committed by the path so far, walking towards this cell
+    TurnSignature arriving = ownSignature.reversed();
+    
+    bool updated = false;
+    int openCount = 0;
+    Edge* openEdge = nullptr;
+    
+    for (Edge* edge : edges) {
+        if (!edge->isUndecided()) {
+            continue;
+        }
+        
+        // A full neighbor cannot take the edge; its own Solve() will exclude it
+        Cell* neighbor = (edge->cell1 == this) ? edge->cell2 : edge->cell1;
+        if (neighbor->getDegree() >= neighbor->getMaxDegree()) {
+            continue;
+        }
+        
+        TurnSignature neighborSignature;
+        Cell* neighborFarEnd = neighbor->tracePath(neighborSignature);
+        if (neighborFarEnd != nullptr && neighborFarEnd != this) {
+            // Joining both paths through this edge must keep a single turn direction
+            TurnSignature joined = TurnSignature::join(arriving, TurnSignature::directionBetween(this, neighbor),
+                                                       neighborSignature);
+            if (joined.getTurnType() == RIGHT_LEFT_MIXED) {
+                edge->setState(EXCLUDED);
+                updated = true;
+                continue;
+            }
+        }
+        
+        openCount++;
+        openEdge = edge;
+    }
     
-    return TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+    // If the far end is an UNMARKED cell that cannot grow any more it is the tail,
+    // so this end has to continue towards a HEAD
+    if (degree == 1 && cellType == UNMARKED && farEnd->cellType == UNMARKED && !farEnd->hasUndecidedEdge()) {
+        if (openCount == 0) {
+            return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+        }
+        
+        if (openCount == 1) {
+            // Forced straight or forced turn continuation
+            openEdge->setState(INCLUDED);
+            return TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED;
+        }
+    }
+    
+    return updated ? TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED 
+                   : TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+}
+
+Cell* Cell::tracePath(TurnSignature& signature) const {
+    const Cell* previous = nullptr;
+    const Cell* current = this;
+    
+    while (true) {
+        // Find the INCLUDED edge that leads away from the previous cell
+        const Cell* next = nullptr;
+        for (Edge* edge : current->edges) {
+            if (edge->isIncluded()) {
+                Cell* otherCell = (edge->cell1 == current) ? edge->cell2 : edge->cell1;
+                if (otherCell != previous) {
+                    next = otherCell;
+                    break;
+                }
+            }
+        }
+        
+        if (next == nullptr) {
+            return const_cast<Cell*>(current);
+        }
+        if (next == this) {
+            return nullptr;
+        }
+        
+        signature.addStep(TurnSignature::directionBetween(current, next));
+        previous = current;
+        current = next;
+    }
+}
+
+int Cell::getMaxDegree() const {
+    return cellType == HEAD ? 1 : 2;
+}
+
+bool Cell::hasUndecidedEdge() const {
+    for (Edge* edge : edges) {
+        if (edge->isUndecided()) {
+            return true;
+        }
+    }
+    return false;
 }
 
 int Cell::getDegree() const {
@@ -1,11 +1,11 @@
 #ifndef CELL_H
 #define CELL_H
 
-#include <vector>
 #include "DataTypes.h"
 
-// Forward declaration
+// Forward declarations
 class Edge;
+struct TurnSignature;
 
 // Enum to represent cell types
 enum CellType {
@@ -13,23 +13,46 @@ enum CellType {
     HEAD
 };
 
+// The edges of a cell, stored inline so cells need no heap allocation.
+// A grid cell has at most four edges; they keep the order in which they were added.
+class CellEdges {
+public:
+    CellEdges() : slots(), count(0) {}
+    
+    void push_back(Edge* edge) { slots[count++] = edge; }
+    Edge* const* begin() const { return slots; }
+    Edge* const* end() const { return slots + count; }
+    int size() const { return count; }
+    
+private:
+    Edge* slots[4];
+    int count;
+};
+
 class Cell {
 private:
     int degree;
+    
+    int getMaxDegree() const;  // 1 for HEAD cells, 2 for UNMARKED cells
+    TurnPuzzleTypes::SolveOutput SolveTurns();  // Apply the single-turn-direction rule at a path end
 
 public:
-    static int idCounter;
-    int id;
+    int id;  // Index of this cell in TurnPuzzle::cells (row * gridSize + col)
     int row;
     int col;
-    bool visited;
+    unsigned visitStamp;  // Traversal generation that last visited this cell, see TurnPuzzle::resetVisitedFlags
     CellType cellType;
-    std::vector<Edge*> edges;
+    CellEdges edges;
     
-    Cell(int r, int c);
+    Cell(int r, int c, int index);
     
     void addEdge(Edge* edge);
     TurnPuzzleTypes::SolveOutput Solve();
+    bool hasUndecidedEdge() const;
+    
+    // Follow INCLUDED edges to the other end of this cell's path.
+    // Returns nullptr if the path is a closed loop.
+    Cell* tracePath(TurnSignature& signature) const;
     
     // Getter and setter for degree
     int getDegree() const;
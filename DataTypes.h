@@ -38,4 +38,18 @@ enum class SolveOutput : uint8_t {
     SOLVE_FAILED
 };
 
+// How FindDifferentSolution picks the edge to branch on
+enum class BranchStrategy : uint8_t {
+    FIRST_UNDECIDED = 0,    // First UNDECIDED edge in edge order
+    MOST_CONSTRAINED_CELL,  // An edge of the cell with the fewest UNDECIDED edges
+    LONGEST_OPEN_PATH,      // An edge extending the longest open path
+    RANDOM_RESTARTS         // Random edge order, restarted with a growing node limit
+};
+
+// Data layout used by the sequential uniqueness search
+enum class SolverEngine : uint8_t {
+    OBJECT_GRAPH = 0,  // Cell and Edge objects with a trail (supports every BranchStrategy)
+    BITBOARD           // Packed edge-state rows, see BitboardEngine
+};
+
 } // namespace TurnPuzzleTypes
@@ -1,7 +1,9 @@
 #include "Edge.h"
 #include "Cell.h"
+#include "Trail.h"
 
-Edge::Edge(Cell* c1, Cell* c2) : cell1(c1), cell2(c2), state(UNDECIDED) {}
+Edge::Edge(Cell* c1, Cell* c2, int edgeId) : id(edgeId), cell1(c1), cell2(c2), state(UNDECIDED), trail(nullptr),
+    stateHash(nullptr), zobristKeys() {}
 
 bool Edge::isUndecided() const {
     return state == UNDECIDED;
@@ -22,6 +24,21 @@ bool Edge::isDeleted() const {
 void Edge::setState(EdgeState newState) {
     if (state == newState) return;
     
+    if (trail != nullptr) {
+        trail->record(this, state);
+    }
+    applyState(newState);
+}
+
+uint64_t Edge::zobristKey() const {
+    return zobristKeys[state == DELETED ? EXCLUDED : state];
+}
+
+void Edge::applyState(EdgeState newState) {
+    if (stateHash != nullptr) {
+        *stateHash ^= zobristKey() ^ zobristKeys[newState == DELETED ? EXCLUDED : newState];
+    }
+    
     // Handle degree changes
     if (state == INCLUDED) {
         // Changing from INCLUDED to something else - decrease degree
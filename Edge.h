@@ -1,8 +1,11 @@
 #ifndef EDGE_H
 #define EDGE_H
 
-// Forward declaration
+#include <cstdint>
+
+// Forward declarations
 class Cell;
+class Trail;
 
 // Enum to represent edge state
 enum EdgeState {
@@ -14,11 +17,15 @@ enum EdgeState {
 
 class Edge {
 public:
+    int id;  // Index of this edge in TurnPuzzle::edges
     Cell* cell1;
     Cell* cell2;
     EdgeState state;
+    Trail* trail;  // Undo log that records state changes, nullptr when not searching
+    uint64_t* stateHash;  // Zobrist hash of all edge states kept up to date, nullptr when not searching
+    uint64_t zobristKeys[3];  // Hash keys for UNDECIDED, INCLUDED and EXCLUDED; DELETED hashes as EXCLUDED
     
-    Edge(Cell* c1, Cell* c2);
+    Edge(Cell* c1, Cell* c2, int edgeId);
     
     bool isUndecided() const;
     bool isIncluded() const;
@@ -26,6 +33,13 @@ public:
     bool isDeleted() const;
     
     void setState(EdgeState newState);
+    uint64_t zobristKey() const;  // Key of the current state
+
+private:
+    friend class Trail;
+
+    // Change the state and cell degrees without recording on the trail
+    void applyState(EdgeState newState);
 };
 
 #endif // EDGE_H
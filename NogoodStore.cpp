@@ -0,0 +1,116 @@
+#include "NogoodStore.h"
+#include <utility>
+
+NogoodStore::NogoodStore() {
+    offsets.push_back(0);
+}
+
+void NogoodStore::reset(int edgeCount) {
+    literals.clear();
+    offsets.assign(1, 0);
+    watches.assign(edgeCount * 2, std::vector<int>());
+    unitLiterals.clear();
+}
+
+bool NogoodStore::add(const std::vector<NogoodLiteral>& nogood) {
+    if (nogood.empty() || nogood.size() > MAX_LENGTH || size() >= MAX_NOGOODS) {
+        return false;
+    }
+
+    int index = static_cast<int>(size());
+    literals.insert(literals.end(), nogood.begin(), nogood.end());
+    offsets.push_back(literals.size());
+
+    watches[watchIndex(nogood[0])].push_back(index);
+    if (nogood.size() == 1) {
+        unitLiterals.push_back(nogood[0]);
+    } else {
+        watches[watchIndex(nogood[1])].push_back(index);
+    }
+    return true;
+}
+
+size_t NogoodStore::size() const {
+    return offsets.size() - 1;
+}
+
+const std::vector<NogoodLiteral>& NogoodStore::getUnitLiterals() const {
+    return unitLiterals;
+}
+
+int NogoodStore::update(NogoodLiteral literal, const std::vector<Edge*>& edges, std::vector<int>& units) {
+    std::vector<int>& watching = watches[watchIndex(literal)];
+    size_t kept = 0;
+    int conflict = -1;
+
+    for (size_t i = 0; i < watching.size(); i++) {
+        int nogood = watching[i];
+        if (conflict != -1) {
+            watching[kept++] = nogood;
+            continue;
+        }
+
+        NogoodLiteral* first = &literals[offsets[nogood]];
+        int length = getLength(nogood);
+        if (length == 1) {
+            watching[kept++] = nogood;
+            conflict = nogood;
+            continue;
+        }
+
+        // Keep the literal that just became true in the second watch
+        if (first[0].edgeId == literal.edgeId && first[0].included == literal.included) {
+            std::swap(first[0], first[1]);
+        }
+
+        // A false literal means the nogood can not become true on this branch
+        if (isFalse(first[0], edges[first[0].edgeId])) {
+            watching[kept++] = nogood;
+            continue;
+        }
+
+        // Watch another literal that is not true instead
+        bool moved = false;
+        for (int k = 2; k < length; k++) {
+            if (!isTrue(first[k], edges[first[k].edgeId])) {
+                std::swap(first[1], first[k]);
+                watches[watchIndex(first[1])].push_back(nogood);
+                moved = true;
+                break;
+            }
+        }
+        if (moved) {
+            continue;
+        }
+
+        watching[kept++] = nogood;
+        if (isTrue(first[0], edges[first[0].edgeId])) {
+            conflict = nogood;
+        } else {
+            units.push_back(nogood);
+        }
+    }
+
+    watching.resize(kept);
+    return conflict;
+}
+
+const NogoodLiteral* NogoodStore::getLiterals(int nogood) const {
+    return &literals[offsets[nogood]];
+}
+
+int NogoodStore::getLength(int nogood) const {
+    return static_cast<int>(offsets[nogood + 1] - offsets[nogood]);
+}
+
+bool NogoodStore::isTrue(NogoodLiteral literal, const Edge* edge) {
+    return literal.included ? edge->isIncluded() : (edge->isExcluded() || edge->isDeleted());
+}
+
+bool NogoodStore::isFalse(NogoodLiteral literal, const Edge* edge) {
+    return literal.included ? (edge->isExcluded() || edge->isDeleted()) : edge->isIncluded();
+}
+
+int NogoodStore::watchIndex(NogoodLiteral literal) {
+    return literal.edgeId * 2 + (literal.included ? 1 : 0);
+}
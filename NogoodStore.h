@@ -0,0 +1,57 @@
+#ifndef NOGOODSTORE_H
+#define NOGOODSTORE_H
+
+#include <cstddef>
+#include <vector>
+#include "Edge.h"
+
+// One edge assignment of a nogood
+struct NogoodLiteral {
+    int edgeId;
+    bool included;  // INCLUDED, or EXCLUDED (a DELETED edge counts as EXCLUDED)
+};
+
+// Nogoods learned by the solver search: sets of edge assignments that together leave no
+// different solution. Each nogood watches two of its literals that are not true, so only the
+// nogoods watching an edge that just changed have to be looked at, and backtracking has
+// nothing to undo.
+class NogoodStore {
+public:
+    static const size_t MAX_LENGTH = 8;  // Longer nogoods cost more to watch than they prune
+    static const size_t MAX_NOGOODS = 1 << 16;  // Learning stops once the store is full
+
+    NogoodStore();
+
+    // Forget every nogood
+    void reset(int edgeCount);
+
+    // The literals have to be true when added, most recently assigned first, so the nogood
+    // watches the two that backtracking undoes first. Returns false if the nogood was not kept.
+    bool add(const std::vector<NogoodLiteral>& literals);
+    size_t size() const;
+
+    // Nogoods made of a single literal, which can never be true
+    const std::vector<NogoodLiteral>& getUnitLiterals() const;
+
+    // Visit the nogoods watching a literal that just became true. Nogoods left with a single
+    // literal that is not true are appended to units, with that literal first.
+    // Returns a nogood whose literals are all true, or -1.
+    int update(NogoodLiteral literal, const std::vector<Edge*>& edges, std::vector<int>& units);
+
+    const NogoodLiteral* getLiterals(int nogood) const;
+    int getLength(int nogood) const;
+
+    static bool isTrue(NogoodLiteral literal, const Edge* edge);
+    static bool isFalse(NogoodLiteral literal, const Edge* edge);
+
+private:
+    // Nogood i is literals[offsets[i]] .. literals[offsets[i + 1] - 1], its watches are the first two
+    std::vector<NogoodLiteral> literals;
+    std::vector<size_t> offsets;
+    std::vector<std::vector<int>> watches;  // Per literal (edgeId * 2 + included): nogoods watching it
+    std::vector<NogoodLiteral> unitLiterals;
+
+    static int watchIndex(NogoodLiteral literal);
+};
+
+#endif // NOGOODSTORE_H
@@ -0,0 +1,188 @@
+#include "ParallelSearch.h"
+#include <thread>
+#include "TurnPuzzle.h"
+
+TaskDeque::TaskDeque() : taskCount(0) {
+}
+
+void TaskDeque::pushBottom(SearchTask task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+    taskCount++;
+}
+
+bool TaskDeque::popBottom(SearchTask& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty()) {
+        return false;
+    }
+    task = std::move(tasks.back());
+    tasks.pop_back();
+    taskCount--;
+    return true;
+}
+
+bool TaskDeque::stealTop(SearchTask& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty()) {
+        return false;
+    }
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    taskCount--;
+    return true;
+}
+
+bool TaskDeque::isEmpty() const {
+    return taskCount.load(std::memory_order_relaxed) == 0;
+}
+
+ParallelSearch::ParallelSearch(TurnPuzzle& source, int threads)
+    : puzzle(source), threadCount(threads), cancelled(false), pendingTasks(0), winner(-1), foundIndex(-1) {
+}
+
+ParallelSearch::~ParallelSearch() {
+}
+
+int ParallelSearch::run(int solutionNumber) {
+    // Copies are made here, before any thread starts
+    workers.clear();
+    deques.clear();
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::unique_ptr<TurnPuzzle>(new TurnPuzzle(puzzle, TurnPuzzle::WorkerTag())));
+        workers[i]->parallelSearch = this;
+        workers[i]->workerIndex = i;
+        deques.push_back(std::make_unique<TaskDeque>());
+    }
+
+    cancelled = false;
+    winner = -1;
+    foundIndex = -1;
+
+    // The whole tree starts as a single task
+    pendingTasks = 1;
+    deques[0]->pushBottom(SearchTask());
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&ParallelSearch::workerLoop, this, i, solutionNumber);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return winner >= 0 ? foundIndex : -1;
+}
+
+const TurnPuzzle* ParallelSearch::getWinner() const {
+    return winner >= 0 ? workers[winner].get() : nullptr;
+}
+
+long long ParallelSearch::getSearchNodes() const {
+    long long nodes = 0;
+    for (const auto& worker : workers) {
+        nodes += worker->getSearchNodes();
+    }
+    return nodes;
+}
+
+long long ParallelSearch::getProbes() const {
+    long long probes = 0;
+    for (const auto& worker : workers) {
+        probes += worker->getProbes();
+    }
+    return probes;
+}
+
+bool ParallelSearch::isCancelled() const {
+    return cancelled.load(std::memory_order_relaxed);
+}
+
+bool ParallelSearch::wantsTask(int worker) const {
+    // Keep one task available for thieves; more would only add replay work
+    return deques[worker]->isEmpty();
+}
+
+void ParallelSearch::pushTask(int worker, const std::vector<SearchDecision>& decisions) {
+    // Count the task before it becomes visible so idle workers never see zero pending work too early
+    pendingTasks++;
+    deques[worker]->pushBottom(SearchTask{decisions});
+    wakeIdle(false);
+}
+
+bool ParallelSearch::reclaimTask(int worker) {
+    // Thieves take the oldest task first, so if the deque is not empty its bottom is our task
+    SearchTask task;
+    if (!deques[worker]->popBottom(task)) {
+        return false;
+    }
+    pendingTasks--;
+    return true;
+}
+
+bool ParallelSearch::takeTask(int worker, SearchTask& task, std::mt19937& rng) {
+    if (deques[worker]->popBottom(task)) {
+        return true;
+    }
+
+    // Try every other worker, starting from a random victim
+    std::uniform_int_distribution<> dis(0, threadCount - 1);
+    int start = dis(rng);
+    for (int i = 0; i < threadCount; i++) {
+        int victim = (start + i) % threadCount;
+        if (victim != worker && deques[victim]->stealTop(task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParallelSearch::hasQueuedTask() const {
+    for (const auto& deque : deques) {
+        if (!deque->isEmpty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelSearch::wakeIdle(bool all) {
+    // Taking the mutex orders this after a waiter's check, so the notification can not be missed
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+    }
+    if (all) {
+        idle.notify_all();
+    } else {
+        idle.notify_one();
+    }
+}
+
+void ParallelSearch::workerLoop(int worker, int solutionNumber) {
+    std::mt19937 rng(worker + 1);
+    SearchTask task;
+
+    while (!cancelled) {
+        if (!takeTask(worker, task, rng)) {
+            std::unique_lock<std::mutex> lock(idleMutex);
+            idle.wait(lock, [this] { return cancelled || pendingTasks == 0 || hasQueuedTask(); });
+            if (cancelled || pendingTasks == 0) {
+                break;
+            }
+            continue;
+        }
+
+        int result = workers[worker]->runSearchTask(task.decisions, solutionNumber);
+        if (result != -1) {
+            int expected = -1;
+            if (winner.compare_exchange_strong(expected, worker)) {
+                foundIndex = result;
+            }
+            cancelled = true;
+            wakeIdle(true);
+        }
+        if (--pendingTasks == 0) {
+            wakeIdle(true);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "Trail.h"
+
+// Forward declaration
+class TurnPuzzle;
+
+// A subtree of the search, described by the decisions that lead to it from the root
+struct SearchTask {
+    std::vector<SearchDecision> decisions;
+};
+
+// Per-worker task deque: the owner pushes and pops at the bottom, thieves steal from the top
+class TaskDeque {
+public:
+    TaskDeque();
+
+    void pushBottom(SearchTask task);
+    bool popBottom(SearchTask& task);
+    bool stealTop(SearchTask& task);
+    bool isEmpty() const;
+
+private:
+    mutable std::mutex mutex;
+    std::deque<SearchTask> tasks;
+    std::atomic<int> taskCount;  // Lets the owner check for emptiness without locking
+};
+
+// Work-stealing version of FindDifferentSolution.
+// Every worker searches its own copy of the puzzle. When a worker's deque is empty it offers
+// the EXCLUDED branch of its next decision as a task; idle workers steal those tasks and
+// replay the decisions on their copy. The first worker to find a different solution cancels the rest.
+class ParallelSearch {
+public:
+    ParallelSearch(TurnPuzzle& puzzle, int threadCount);
+    ~ParallelSearch();
+
+    // Returns the differing edge index or -1. The winning worker's copy holds the solution.
+    int run(int solutionNumber);
+    const TurnPuzzle* getWinner() const;
+    long long getSearchNodes() const;
+    long long getProbes() const;
+
+    // Called by the workers from FindDifferentSolution
+    bool isCancelled() const;
+    bool wantsTask(int worker) const;
+    void pushTask(int worker, const std::vector<SearchDecision>& decisions);
+    bool reclaimTask(int worker);  // Pop the task this worker offered last, false if it was stolen
+
+private:
+    TurnPuzzle& puzzle;
+    int threadCount;
+    std::vector<std::unique_ptr<TurnPuzzle>> workers;
+    std::vector<std::unique_ptr<TaskDeque>> deques;
+    std::atomic<bool> cancelled;
+    std::atomic<int> pendingTasks;  // Tasks queued or being run at the top level of a worker
+    std::atomic<int> winner;
+    int foundIndex;
+    std::mutex idleMutex;
+    std::condition_variable idle;  // Workers without a task wait here until one is offered or the search ends
+
+    void workerLoop(int worker, int solutionNumber);
+    bool takeTask(int worker, SearchTask& task, std::mt19937& rng);
+    bool hasQueuedTask() const;
+    void wakeIdle(bool all);
+};
+
+#endif // PARALLELSEARCH_H
@@ -1,78 +1,146 @@
 #include "Path.h"
 #include "TurnPuzzle.h"
 
-Path::Path() : turnType(STRAIGHT), dirty(true) {
-}
+namespace {
 
-void Path::addCell(Cell* cell) {
-    cells.push_back(cell);
-    dirty = true;
+int rowDelta(TurnPuzzleTypes::Direction dir) {
+    if (dir == TurnPuzzleTypes::UP) return -1;
+    if (dir == TurnPuzzleTypes::DOWN) return 1;
+    return 0;
 }
 
-int Path::getLength() const {
-    return cells.size();
+int colDelta(TurnPuzzleTypes::Direction dir) {
+    if (dir == TurnPuzzleTypes::LEFT) return -1;
+    if (dir == TurnPuzzleTypes::RIGHT) return 1;
+    return 0;
 }
 
-void Path::calculateTurnType() {
-    // If not dirty, return the cached value
-    if (!dirty) {
+// Record the turn made when moving in dir1 and then in dir2
+void addTurn(TurnPuzzleTypes::Direction dir1, TurnPuzzleTypes::Direction dir2, bool& hasLeftTurn, bool& hasRightTurn) {
+    if (dir1 == TurnPuzzleTypes::NONE || dir2 == TurnPuzzleTypes::NONE) {
         return;
     }
-    
-    dirty = false;
-    // If path has less than 3 cells, it's straight (no turns possible)
-    if (cells.size() < 3) {
-        turnType = STRAIGHT;
-        return;
+
+    // Using cross product: positive = left turn, negative = right turn
+    int crossProduct = rowDelta(dir1) * colDelta(dir2) - colDelta(dir1) * rowDelta(dir2);
+
+    if (crossProduct > 0) {
+        hasLeftTurn = true;
+    } else if (crossProduct < 0) {
+        hasRightTurn = true;
     }
-    
-    bool hasRightTurn = false;
-    bool hasLeftTurn = false;
-    
-    // Check each consecutive triple of cells to detect turns
-    for (size_t i = 0; i < cells.size() - 2; i++) {
-        Cell* cell1 = cells[i];
-        Cell* cell2 = cells[i + 1];
-        Cell* cell3 = cells[i + 2];
-        
-        // Calculate direction from cell1 to cell2
-        int dir1Row = cell2->row - cell1->row;
-        int dir1Col = cell2->col - cell1->col;
-        
-        // Calculate direction from cell2 to cell3
-        int dir2Row = cell3->row - cell2->row;
-        int dir2Col = cell3->col - cell2->col;
-        
-        // If directions are the same, no turn
-        if (dir1Row == dir2Row && dir1Col == dir2Col) {
-            continue;
-        }
-        
-        // Determine if it's a right or left turn
-        // Using cross product: positive = left turn, negative = right turn
-        int crossProduct = dir1Row * dir2Col - dir1Col * dir2Row;
-        
-        if (crossProduct > 0) {
-            hasLeftTurn = true;
-        } else if (crossProduct < 0) {
-            hasRightTurn = true;
-        }
-        
-        // If we have both types, we can stop early
-        if (hasRightTurn && hasLeftTurn) {
-            break;
-        }
+}
+
+} // namespace
+
+TurnSignature::TurnSignature()
+    : firstDirection(TurnPuzzleTypes::NONE), lastDirection(TurnPuzzleTypes::NONE),
+      hasLeftTurn(false), hasRightTurn(false) {
+}
+
+void TurnSignature::addStep(TurnPuzzleTypes::Direction step) {
+    addTurn(lastDirection, step, hasLeftTurn, hasRightTurn);
+    if (firstDirection == TurnPuzzleTypes::NONE) {
+        firstDirection = step;
     }
-    
-    // Set the turn type based on what we found
+    lastDirection = step;
+}
+
+TurnSignature TurnSignature::reversed() const {
+    // Walking backwards swaps the end directions and mirrors every turn
+    TurnSignature result;
+    result.firstDirection = reverseDirection(lastDirection);
+    result.lastDirection = reverseDirection(firstDirection);
+    result.hasLeftTurn = hasRightTurn;
+    result.hasRightTurn = hasLeftTurn;
+    return result;
+}
+
+TurnType TurnSignature::getTurnType() const {
     if (hasRightTurn && hasLeftTurn) {
-        // Mixed turns - shouldn't happen in a valid puzzle, default to STRAIGHT
-        turnType = RIGHT_LEFT_MIXED;
+        return RIGHT_LEFT_MIXED;
     } else if (hasRightTurn) {
-        turnType = RIGHT_ONLY;
+        return RIGHT_ONLY;
     } else if (hasLeftTurn) {
-        turnType = LEFT_ONLY;
-    } else {
-        turnType = STRAIGHT;
+        return LEFT_ONLY;
+    }
+    return STRAIGHT;
+}
+
+TurnSignature TurnSignature::join(const TurnSignature& first, TurnPuzzleTypes::Direction step, const TurnSignature& second) {
+    TurnSignature result = first;
+    result.addStep(step);
+
+    // Turn where the second path starts, then everything inside it
+    addTurn(step, second.firstDirection, result.hasLeftTurn, result.hasRightTurn);
+    result.hasLeftTurn = result.hasLeftTurn || second.hasLeftTurn;
+    result.hasRightTurn = result.hasRightTurn || second.hasRightTurn;
+    if (second.lastDirection != TurnPuzzleTypes::NONE) {
+        result.lastDirection = second.lastDirection;
     }
+    return result;
+}
+
+TurnPuzzleTypes::Direction TurnSignature::directionBetween(const Cell* from, const Cell* to) {
+    if (to->row < from->row) return TurnPuzzleTypes::UP;
+    if (to->row > from->row) return TurnPuzzleTypes::DOWN;
+    if (to->col < from->col) return TurnPuzzleTypes::LEFT;
+    if (to->col > from->col) return TurnPuzzleTypes::RIGHT;
+    return TurnPuzzleTypes::NONE;
+}
+
+TurnPuzzleTypes::Direction TurnSignature::reverseDirection(TurnPuzzleTypes::Direction dir) {
+    switch (dir) {
+        case TurnPuzzleTypes::UP:    return TurnPuzzleTypes::DOWN;
+        case TurnPuzzleTypes::DOWN:  return TurnPuzzleTypes::UP;
+        case TurnPuzzleTypes::LEFT:  return TurnPuzzleTypes::RIGHT;
+        case TurnPuzzleTypes::RIGHT: return TurnPuzzleTypes::LEFT;
+        default:                     return TurnPuzzleTypes::NONE;
+    }
+}
+
+Path::Path() : turnType(STRAIGHT) {
+}
+
+void Path::addCell(Cell* cell) {
+    // Keep the turn signature up to date so classifying the path never rescans it
+    if (!cells.empty()) {
+        signature.addStep(TurnSignature::directionBetween(cells.back(), cell));
+    }
+    cells.push_back(cell);
+}
+
+int Path::getLength() const {
+    return cells.size();
+}
+
+void Path::calculateTurnType() {
+    turnType = signature.getTurnType();
+}
+
+PathBuffer::PathBuffer() : offsets(1, 0) {
+}
+
+void PathBuffer::clear() {
+    cellIndices.clear();
+    offsets.assign(1, 0);
+}
+
+void PathBuffer::endPath() {
+    offsets.push_back(cellIndices.size());
+}
+
+int PathBuffer::getPathCount() const {
+    return offsets.size() - 1;
+}
+
+int PathBuffer::getPathLength(int path) const {
+    return offsets[path + 1] - offsets[path];
+}
+
+PathValidation::PathValidation() : mixedTurns(false), headToHead(false), coveredCells(0) {
+}
+
+bool PathValidation::isValid() const {
+    return !mixedTurns && !headToHead;
 }
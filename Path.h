@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "Cell.h"
+#include "DataTypes.h"
 
 // Enum to represent turn types
 enum TurnType {
@@ -12,17 +13,69 @@ enum TurnType {
     RIGHT_LEFT_MIXED
 };
 
+// Compact summary of the turns along a path, walking from its first cell to its last cell.
+// Two signatures joined through an edge merge in constant time.
+struct TurnSignature {
+    TurnPuzzleTypes::Direction firstDirection;  // First step of the path (NONE for a single cell)
+    TurnPuzzleTypes::Direction lastDirection;   // Last step of the path (NONE for a single cell)
+    bool hasLeftTurn;
+    bool hasRightTurn;
+
+    TurnSignature();
+
+    // Extend the path by one step in the given direction
+    void addStep(TurnPuzzleTypes::Direction step);
+
+    // Signature of the same path walked from its last cell to its first cell
+    TurnSignature reversed() const;
+
+    TurnType getTurnType() const;
+
+    // Signature of first, followed by one step, followed by second
+    static TurnSignature join(const TurnSignature& first, TurnPuzzleTypes::Direction step, const TurnSignature& second);
+
+    static TurnPuzzleTypes::Direction directionBetween(const Cell* from, const Cell* to);
+    static TurnPuzzleTypes::Direction reverseDirection(TurnPuzzleTypes::Direction dir);
+};
+
 class Path {
 public:
     std::vector<Cell*> cells;
     TurnType turnType;
-    bool dirty;
-    
+    TurnSignature signature;
+
     Path();
-    
+
     void addCell(Cell* cell);
     int getLength() const;
     void calculateTurnType();
 };
 
+// HEAD paths stored back to back as cell indices: path i is
+// cellIndices[offsets[i]] .. cellIndices[offsets[i + 1] - 1].
+// clear() keeps the capacity, so a reused buffer stops allocating once it has grown.
+class PathBuffer {
+public:
+    std::vector<int> cellIndices;
+    std::vector<int> offsets;
+
+    PathBuffer();
+
+    void clear();
+    void endPath();  // Closes the path made of the indices appended since the previous path
+    int getPathCount() const;
+    int getPathLength(int path) const;
+};
+
+// Result of checking the HEAD paths without storing them
+struct PathValidation {
+    bool mixedTurns;   // A path turns both ways
+    bool headToHead;   // A path runs from one HEAD to another
+    int coveredCells;  // Cells on the HEAD paths checked before the first failure
+
+    PathValidation();
+
+    bool isValid() const;
+};
+
 #endif // PATH_H
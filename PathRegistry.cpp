@@ -0,0 +1,46 @@
+#include "PathRegistry.h"
+
+PathRegistry::PathRegistry() : gridSize(0) {
+}
+
+void PathRegistry::reset(int size) {
+    gridSize = size;
+    ends.resize(gridSize * gridSize);
+    for (int i = 0; i < static_cast<int>(ends.size()); i++) {
+        ends[i] = {i, 1, TurnSignature()};
+    }
+}
+
+int PathRegistry::indexOf(const Cell* cell) const {
+    return cell->row * gridSize + cell->col;
+}
+
+const PathRegistry::PathEnd& PathRegistry::getEnd(const Cell* cell) const {
+    return ends[indexOf(cell)];
+}
+
+bool PathRegistry::formsLoop(const Cell* from, const Cell* to) const {
+    return ends[indexOf(from)].partner == indexOf(to);
+}
+
+TurnSignature PathRegistry::joinedSignature(const Cell* from, const Cell* to) const {
+    // Walking order of the combined path: far end of from's path -> from -> to -> far end of to's path
+    const PathEnd& fromFar = ends[ends[indexOf(from)].partner];
+    return TurnSignature::join(fromFar.signature, TurnSignature::directionBetween(from, to),
+                               ends[indexOf(to)].signature);
+}
+
+bool PathRegistry::wouldMixTurns(const Cell* from, const Cell* to) const {
+    return joinedSignature(from, to).getTurnType() == RIGHT_LEFT_MIXED;
+}
+
+void PathRegistry::join(const Cell* from, const Cell* to) {
+    TurnSignature signature = joinedSignature(from, to);
+
+    int fromFar = ends[indexOf(from)].partner;
+    int toFar = ends[indexOf(to)].partner;
+    int length = ends[indexOf(from)].length + ends[indexOf(to)].length;
+
+    ends[fromFar] = {toFar, length, signature};
+    ends[toFar] = {fromFar, length, signature.reversed()};
+}
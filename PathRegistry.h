@@ -0,0 +1,43 @@
+#ifndef PATHREGISTRY_H
+#define PATHREGISTRY_H
+
+#include <vector>
+#include "Path.h"
+
+// Endpoint-linked index of the partial paths formed by INCLUDED edges.
+// Every path is described by the records stored at its two endpoint cells,
+// so joining two paths and checking the result are O(1) operations.
+class PathRegistry {
+public:
+    // Information about a path as seen from one of its endpoints
+    struct PathEnd {
+        int partner;              // Cell index of the other endpoint
+        int length;               // Number of cells in the path
+        TurnSignature signature;  // Turns seen when walking from this end to the partner
+    };
+
+    PathRegistry();
+
+    // Start over with every cell being a single-cell path
+    void reset(int gridSize);
+
+    // Record that an INCLUDED edge now connects two path endpoints
+    void join(const Cell* from, const Cell* to);
+
+    // True if from and to are the two ends of the same path
+    bool formsLoop(const Cell* from, const Cell* to) const;
+
+    // True if connecting from and to would give a path with both turn directions
+    bool wouldMixTurns(const Cell* from, const Cell* to) const;
+
+    const PathEnd& getEnd(const Cell* cell) const;
+
+private:
+    int gridSize;
+    std::vector<PathEnd> ends;  // Indexed by row * gridSize + col; valid for endpoint cells only
+
+    int indexOf(const Cell* cell) const;
+    TurnSignature joinedSignature(const Cell* from, const Cell* to) const;
+};
+
+#endif // PATHREGISTRY_H
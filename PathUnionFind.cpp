@@ -0,0 +1,78 @@
+#include "PathUnionFind.h"
+#include <utility>
+
+PathUnionFind::PathUnionFind() {
+}
+
+void PathUnionFind::reset(int cellCount) {
+    parent.resize(cellCount);
+    size.assign(cellCount, 1);
+    end1.resize(cellCount);
+    end2.resize(cellCount);
+    reasons.assign(cellCount, 0);
+    for (int i = 0; i < cellCount; i++) {
+        parent[i] = i;
+        end1[i] = i;
+        end2[i] = i;
+    }
+    joins.clear();
+}
+
+int PathUnionFind::find(int cell) const {
+    // Union by size keeps the trees O(log n) deep
+    while (parent[cell] != cell) {
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+bool PathUnionFind::connected(int first, int second) const {
+    return find(first) == find(second);
+}
+
+bool PathUnionFind::join(int first, int second, size_t mark, uint64_t reason) {
+    int firstRoot = find(first);
+    int secondRoot = find(second);
+    if (firstRoot == secondRoot) {
+        return false;
+    }
+
+    // The far ends of both paths become the ends of the joined path
+    int firstFar = end1[firstRoot] == first ? end2[firstRoot] : end1[firstRoot];
+    int secondFar = end1[secondRoot] == second ? end2[secondRoot] : end1[secondRoot];
+
+    if (size[firstRoot] < size[secondRoot]) {
+        std::swap(firstRoot, secondRoot);
+    }
+    joins.push_back({mark, secondRoot, firstRoot, end1[firstRoot], end2[firstRoot], reasons[firstRoot]});
+    parent[secondRoot] = firstRoot;
+    size[firstRoot] += size[secondRoot];
+    end1[firstRoot] = firstFar;
+    end2[firstRoot] = secondFar;
+    reasons[firstRoot] |= reasons[secondRoot] | reason;
+    return true;
+}
+
+int PathUnionFind::getEnd1(int cell) const {
+    return end1[find(cell)];
+}
+
+int PathUnionFind::getEnd2(int cell) const {
+    return end2[find(cell)];
+}
+
+uint64_t PathUnionFind::getReason(int cell) const {
+    return reasons[find(cell)];
+}
+
+void PathUnionFind::undoTo(size_t mark) {
+    while (!joins.empty() && joins.back().mark >= mark) {
+        const Join& join = joins.back();
+        parent[join.child] = join.child;
+        size[join.root] -= size[join.child];
+        end1[join.root] = join.rootEnd1;
+        end2[join.root] = join.rootEnd2;
+        reasons[join.root] = join.rootReason;
+        joins.pop_back();
+    }
+}
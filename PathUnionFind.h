@@ -0,0 +1,55 @@
+#ifndef PATHUNIONFIND_H
+#define PATHUNIONFIND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Union-find over the cells joined by INCLUDED edges, used by the solver search.
+// Union by size without path compression keeps every join undoable in O(1), so the
+// structure can follow the trail when the search backtracks. Each root also records
+// the two end cells of its path, which is what loop checks need, and the union of the
+// reasons of its edges (decision-level bits, see TurnPuzzle::edgeReason).
+class PathUnionFind {
+public:
+    PathUnionFind();
+
+    // Start over with every cell being a single-cell path
+    void reset(int cellCount);
+
+    int find(int cell) const;
+    bool connected(int first, int second) const;
+
+    // Join the paths ending at first and second. Returns false, without joining, if they
+    // are already connected, since the edge would close a loop.
+    // mark is the caller's undo position (a trail index) recorded with the join, reason the
+    // reason of the joining edge.
+    bool join(int first, int second, size_t mark, uint64_t reason);
+
+    // The two end cells of the path containing cell (equal for a single cell)
+    int getEnd1(int cell) const;
+    int getEnd2(int cell) const;
+    uint64_t getReason(int cell) const;  // Union of the reasons of the path's edges
+
+    // Undo every join recorded with a mark at or after the given one, newest first
+    void undoTo(size_t mark);
+
+private:
+    struct Join {
+        size_t mark;
+        int child;     // Root that was attached below root
+        int root;
+        int rootEnd1;  // Ends of root's path before the join
+        int rootEnd2;
+        uint64_t rootReason;
+    };
+
+    std::vector<int> parent;
+    std::vector<int> size;
+    std::vector<int> end1;  // Valid at roots only
+    std::vector<int> end2;
+    std::vector<uint64_t> reasons;  // Valid at roots only
+    std::vector<Join> joins;
+};
+
+#endif // PATHUNIONFIND_H
@@ -0,0 +1,252 @@
+#include "PuzzleCorpus.h"
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "TurnPuzzle.h"
+
+static const char CORPUS_MAGIC[8] = {'T', 'U', 'R', 'N', 'C', 'R', 'P', '1'};
+
+static size_t bitsetBytes(size_t bits) {
+    return (bits + 7) / 8;
+}
+
+size_t PuzzleCorpus::recordSize(int gridSize) {
+    // In size_t, so checking the header of a huge grid can not overflow
+    size_t size = gridSize;
+    return 2 + bitsetBytes(size * size) + 2 * bitsetBytes(2 * size * (size - 1));
+}
+
+int PuzzleCorpus::edgeCount(int gridSize) {
+    return 2 * gridSize * (gridSize - 1);
+}
+
+bool PuzzleCorpus::checkHeader(const unsigned char* header, int& gridSize) {
+    uint32_t sizes[2];
+    std::memcpy(sizes, header + sizeof(CORPUS_MAGIC), sizeof(sizes));
+    if (std::memcmp(header, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0 || sizes[0] < 2 || sizes[0] > 0xffff ||
+        sizes[1] != recordSize(sizes[0])) {
+        return false;
+    }
+    gridSize = sizes[0];
+    return true;
+}
+
+bool PuzzleCorpus::readHeader(std::istream& input, int& gridSize) {
+    unsigned char header[HEADER_SIZE];
+    return input.read(reinterpret_cast<char*>(header), sizeof(header)) && checkHeader(header, gridSize);
+}
+
+void PuzzleCorpus::pack(const TurnPuzzle& puzzle, std::vector<unsigned char>& record) {
+    int gridSize = puzzle.gridSize;
+    size_t headBytes = bitsetBytes(gridSize * gridSize);
+    size_t edgeBytes = bitsetBytes(edgeCount(gridSize));
+    record.assign(recordSize(gridSize), 0);
+    record[0] = static_cast<unsigned char>(gridSize & 0xff);
+    record[1] = static_cast<unsigned char>(gridSize >> 8);
+
+    unsigned char* heads = &record[2];
+    unsigned char* walls = heads + headBytes;
+    unsigned char* solution = walls + edgeBytes;
+    for (const Cell* cell : puzzle.cells) {
+        if (cell->cellType == HEAD) {
+            heads[cell->id >> 3] |= 1 << (cell->id & 7);
+        }
+    }
+    for (const Edge* edge : puzzle.edges) {
+        if (edge->isDeleted()) {
+            walls[edge->id >> 3] |= 1 << (edge->id & 7);
+        }
+    }
+    for (size_t i = 0; i < puzzle.originalSolution.size(); i++) {
+        if (puzzle.originalSolution[i] == INCLUDED) {
+            solution[i >> 3] |= 1 << (i & 7);
+        }
+    }
+}
+
+PuzzleCorpusWriter::PuzzleCorpusWriter() : gridSize(0) {
+}
+
+bool PuzzleCorpusWriter::open(const std::string& path, int size) {
+    close();
+    gridSize = size;
+    uint32_t header[2] = {static_cast<uint32_t>(gridSize), static_cast<uint32_t>(PuzzleCorpus::recordSize(gridSize))};
+
+    std::error_code error;
+    uintmax_t fileSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+    if (error) {
+        std::cerr << "Failed to read corpus: " << path << std::endl;
+        return false;
+    }
+
+    if (fileSize > 0) {
+        int existingSize;
+        std::ifstream in(path, std::ios::binary);
+        if (!PuzzleCorpus::readHeader(in, existingSize)) {
+            std::cerr << "Not a puzzle corpus: " << path << std::endl;
+            return false;
+        }
+        if (existingSize != gridSize) {
+            std::cerr << "Corpus " << path << " holds " << existingSize << "x" << existingSize << " puzzles" << std::endl;
+            return false;
+        }
+
+        // Drop a record cut short by an earlier crash, so new records start on a record boundary
+        uintmax_t whole = PuzzleCorpus::HEADER_SIZE +
+                          (fileSize - PuzzleCorpus::HEADER_SIZE) / header[1] * header[1];
+        if (whole != fileSize) {
+            std::filesystem::resize_file(path, whole, error);
+            if (error) {
+                std::cerr << "Failed to repair corpus: " << path << std::endl;
+                return false;
+            }
+        }
+    }
+
+    file.open(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    if (fileSize == 0) {
+        file.write(CORPUS_MAGIC, sizeof(CORPUS_MAGIC));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+    return static_cast<bool>(file);
+}
+
+bool PuzzleCorpusWriter::append(const TurnPuzzle& puzzle) {
+    PuzzleCorpus::pack(puzzle, scratch);
+    return append(scratch);
+}
+
+bool PuzzleCorpusWriter::append(const std::vector<unsigned char>& record) {
+    if (!file.is_open() || record.size() != PuzzleCorpus::recordSize(gridSize) ||
+        (record[0] | (record[1] << 8)) != gridSize) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(record.data()), record.size());
+    return static_cast<bool>(file);
+}
+
+void PuzzleCorpusWriter::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+PuzzleCorpusReader::PuzzleCorpusReader()
+    : data(nullptr), mappedSize(0), gridSize(0), recordBytes(0), recordCount(0), headBytes(0), edgeBytes(0) {
+}
+
+PuzzleCorpusReader::~PuzzleCorpusReader() {
+    close();
+}
+
+bool PuzzleCorpusReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < PuzzleCorpus::HEADER_SIZE) {
+        ::close(fd);
+        std::cerr << "Not a puzzle corpus: " << path << std::endl;
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map corpus: " << path << std::endl;
+        return false;
+    }
+    data = static_cast<const unsigned char*>(mapping);
+    mappedSize = info.st_size;
+
+    if (!PuzzleCorpus::checkHeader(data, gridSize)) {
+        close();
+        std::cerr << "Not a puzzle corpus: " << path << std::endl;
+        return false;
+    }
+
+    recordBytes = PuzzleCorpus::recordSize(gridSize);
+    recordCount = (mappedSize - PuzzleCorpus::HEADER_SIZE) / recordBytes;
+    headBytes = bitsetBytes(static_cast<size_t>(gridSize) * gridSize);
+    edgeBytes = (recordBytes - 2 - headBytes) / 2;
+
+    // Records are read in file order most of the time
+    madvise(mapping, mappedSize, MADV_SEQUENTIAL);
+    return true;
+}
+
+void PuzzleCorpusReader::close() {
+    if (data != nullptr) {
+        munmap(const_cast<unsigned char*>(data), mappedSize);
+    }
+    data = nullptr;
+    mappedSize = 0;
+    recordCount = 0;
+}
+
+size_t PuzzleCorpusReader::size() const {
+    return recordCount;
+}
+
+int PuzzleCorpusReader::getGridSize() const {
+    return gridSize;
+}
+
+const unsigned char* PuzzleCorpusReader::getRecord(size_t index) const {
+    return data + PuzzleCorpus::HEADER_SIZE + index * recordBytes;
+}
+
+bool PuzzleCorpusReader::isHead(size_t index, int cellId) const {
+    return PuzzleCorpus::getBit(getRecord(index) + 2, cellId);
+}
+
+bool PuzzleCorpusReader::isWall(size_t index, int edgeId) const {
+    return PuzzleCorpus::getBit(getRecord(index) + 2 + headBytes, edgeId);
+}
+
+bool PuzzleCorpusReader::isSolutionEdge(size_t index, int edgeId) const {
+    return PuzzleCorpus::getBit(getRecord(index) + 2 + headBytes + edgeBytes, edgeId);
+}
+
+std::unique_ptr<TurnPuzzle> PuzzleCorpusReader::load(size_t index, bool showSolution, const std::string& filePrefix,
+                                                     std::ostream& output) const {
+    if (index >= recordCount) {
+        return nullptr;
+    }
+
+    std::unique_ptr<TurnPuzzle> puzzle(new TurnPuzzle(gridSize, filePrefix, output));
+    for (Cell* cell : puzzle->cells) {
+        if (isHead(index, cell->id)) {
+            cell->cellType = HEAD;
+        }
+    }
+
+    // Same states as markCells saves: the solution's edges INCLUDED, the rest UNDECIDED
+    for (Edge* edge : puzzle->edges) {
+        if (isSolutionEdge(index, edge->id)) {
+            edge->setState(INCLUDED);
+        }
+    }
+    puzzle->SaveEdgeStates(puzzle->originalSolution);
+
+    for (Edge* edge : puzzle->edges) {
+        if (isWall(index, edge->id)) {
+            edge->setState(DELETED);
+        } else if (!showSolution) {
+            edge->setState(UNDECIDED);
+        }
+    }
+    return puzzle;
+}
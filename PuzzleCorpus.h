@@ -0,0 +1,90 @@
+#ifndef PUZZLECORPUS_H
+#define PUZZLECORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward declaration
+class TurnPuzzle;
+
+// Binary corpus of puzzles that share a grid size.
+// The file starts with a 16 byte header: the magic "TURNCRP1", then the grid size and the record size
+// as 32-bit integers in host byte order. Fixed-size records follow, so record i starts at
+// HEADER_SIZE + i * recordSize. A record holds the grid size (16 bits), then three bitsets, each
+// padded to whole bytes: HEAD cells by cell id, DELETED walls by edge id, and the edges of the
+// solution by edge id.
+class PuzzleCorpus {
+public:
+    static const size_t HEADER_SIZE = 16;
+
+    static size_t recordSize(int gridSize);
+    static int edgeCount(int gridSize);
+
+    // Check the HEADER_SIZE bytes of a corpus header; false if they are not one
+    static bool checkHeader(const unsigned char* header, int& gridSize);
+    // Read and check a corpus header; false if the input does not start with one
+    static bool readHeader(std::istream& input, int& gridSize);
+
+    // Pack the HEAD cells, walls and original solution of a puzzle into a record
+    static void pack(const TurnPuzzle& puzzle, std::vector<unsigned char>& record);
+
+    static bool getBit(const unsigned char* bits, int index) {
+        return (bits[index >> 3] >> (index & 7)) & 1;
+    }
+};
+
+// Appends records to a corpus file, creating it with a header if it is empty
+class PuzzleCorpusWriter {
+public:
+    PuzzleCorpusWriter();
+
+    // False if the file can not be opened or holds another grid size
+    bool open(const std::string& path, int gridSize);
+    bool append(const TurnPuzzle& puzzle);
+    bool append(const std::vector<unsigned char>& record);  // A record made by PuzzleCorpus::pack
+    void close();
+
+private:
+    std::ofstream file;
+    int gridSize;
+    std::vector<unsigned char> scratch;
+};
+
+// Memory-mapped corpus: records are read in place, without parsing
+class PuzzleCorpusReader {
+public:
+    PuzzleCorpusReader();
+    ~PuzzleCorpusReader();
+
+    bool open(const std::string& path);  // False if the file is missing or not a corpus
+    void close();
+
+    size_t size() const;  // Whole records in the file; a record cut short by a crash is left out
+    int getGridSize() const;
+    const unsigned char* getRecord(size_t index) const;
+
+    bool isHead(size_t index, int cellId) const;
+    bool isWall(size_t index, int edgeId) const;
+    bool isSolutionEdge(size_t index, int edgeId) const;
+
+    // Rebuild a puzzle as left by solvePuzzle: HEAD cells, walls, and the original solution to
+    // search against. With showSolution the solution edges are INCLUDED, ready for exportToSVG.
+    std::unique_ptr<TurnPuzzle> load(size_t index, bool showSolution = false, const std::string& filePrefix = "",
+                                     std::ostream& output = std::cout) const;
+
+private:
+    const unsigned char* data;
+    size_t mappedSize;
+    int gridSize;
+    size_t recordBytes;
+    size_t recordCount;
+    size_t headBytes;  // Bytes of the HEAD bitset
+    size_t edgeBytes;  // Bytes of the wall and solution bitsets
+};
+
+#endif // PUZZLECORPUS_H
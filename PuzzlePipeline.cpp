@@ -0,0 +1,212 @@
+#include "PuzzlePipeline.h"
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <thread>
+#include "PuzzleCorpus.h"
+#include "TurnPuzzle.h"
+
+static const char* const STAGE_NAMES[STAGE_COUNT] = {"generate", "mark", "verify", "export"};
+
+// A puzzle on its way through the pipeline
+struct PuzzlePipeline::PipelineJob {
+    BatchResult result;
+    std::ostream discard;  // Console of the puzzle; without a buffer it drops everything
+    std::unique_ptr<TurnPuzzle> puzzle;
+
+    PipelineJob() : discard(nullptr) {}
+};
+
+PuzzlePipeline::PuzzlePipeline(const BatchSettings& settings, const int (&stageWorkers)[STAGE_COUNT],
+                               size_t queueCapacity)
+    : settings(settings), nextIndex(0), runSeconds(0) {
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        workers[stage] = stageWorkers[stage] < 1 ? 1 : stageWorkers[stage];
+        if (stage != GENERATE_STAGE) {
+            queues[stage].reset(new JobQueue(queueCapacity));
+        }
+    }
+}
+
+PuzzlePipeline::~PuzzlePipeline() {
+}
+
+std::vector<BatchResult> PuzzlePipeline::run() {
+    results.assign(settings.puzzleCount > 0 ? settings.puzzleCount : 0, BatchResult());
+    nextIndex = 0;
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        StageCounters& counter = counters[stage];
+        counter.activeWorkers = workers[stage];
+        counter.puzzles = 0;
+        counter.busyNanoseconds = 0;
+        counter.depthSum = 0;
+        counter.depthSamples = 0;
+        counter.maxDepth = 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        for (int i = 0; i < workers[stage]; i++) {
+            threads.emplace_back(&PuzzlePipeline::workerLoop, this, stage);
+        }
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return results;
+}
+
+std::vector<StageMetrics> PuzzlePipeline::getMetrics() const {
+    std::vector<StageMetrics> metrics;
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        const StageCounters& counter = counters[stage];
+        StageMetrics stageMetrics;
+        stageMetrics.name = STAGE_NAMES[stage];
+        stageMetrics.workers = workers[stage];
+        stageMetrics.puzzles = counter.puzzles;
+        stageMetrics.busySeconds = counter.busyNanoseconds / 1e9;
+        stageMetrics.puzzlesPerSecond = runSeconds > 0 ? stageMetrics.puzzles / runSeconds : 0.0;
+        // Busy time per worker is how long the stage alone would have taken
+        double stageSeconds = stageMetrics.busySeconds / workers[stage];
+        stageMetrics.capacityPerSecond = stageSeconds > 0 ? stageMetrics.puzzles / stageSeconds : 0.0;
+        stageMetrics.maxQueueDepth = counter.maxDepth;
+        long long samples = counter.depthSamples;
+        stageMetrics.averageQueueDepth = samples > 0 ? static_cast<double>(counter.depthSum) / samples : 0.0;
+        metrics.push_back(stageMetrics);
+    }
+    return metrics;
+}
+
+void PuzzlePipeline::workerLoop(int stage) {
+    std::unique_ptr<PipelineJob> job;
+    while (takeJob(stage, job)) {
+        auto start = std::chrono::steady_clock::now();
+        process(stage, *job);
+        auto busy = std::chrono::steady_clock::now() - start;
+        counters[stage].busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count();
+        counters[stage].puzzles++;
+        passOn(stage, job);
+    }
+
+    // Pushes made before this are seen by the next stage once it sees the count drop
+    if (counters[stage].activeWorkers.fetch_sub(1, std::memory_order_release) == 1 && stage != EXPORT_STAGE) {
+        QueueSignal& next = signals[stage + 1];
+        notify(next, next.notEmpty, true);
+    }
+}
+
+bool PuzzlePipeline::takeJob(int stage, std::unique_ptr<PipelineJob>& job) {
+    if (stage == GENERATE_STAGE) {
+        int index = nextIndex++;
+        if (index >= static_cast<int>(results.size())) {
+            return false;
+        }
+        job.reset(new PipelineJob());
+        job->result.index = index;
+        job->result.seed = BatchGenerator::puzzleSeed(settings.firstSeed, index);
+        job->result.filePrefix = settings.filePrefix + "puzzle-" + std::to_string(job->result.seed) + "-";
+        job->result.covered = false;
+        job->result.walls = 0;
+        job->result.searchNodes = 0;
+        return true;
+    }
+
+    JobQueue& queue = *queues[stage];
+    QueueSignal& signal = signals[stage];
+    StageCounters& counter = counters[stage];
+    while (true) {
+        // Check the previous stage first: once it is done, an empty queue stays empty
+        bool upstreamDone = counters[stage - 1].activeWorkers.load(std::memory_order_acquire) == 0;
+        size_t depth = queue.size();
+        if (queue.tryPop(job)) {
+            counter.depthSum += depth;
+            counter.depthSamples++;
+            size_t maxDepth = counter.maxDepth.load(std::memory_order_relaxed);
+            while (depth > maxDepth && !counter.maxDepth.compare_exchange_weak(maxDepth, depth)) {
+            }
+            notify(signal, signal.notFull, false);
+            return true;
+        }
+        if (upstreamDone) {
+            return false;
+        }
+
+        // Park until the previous stage pushes a job or finishes
+        std::unique_lock<std::mutex> lock(signal.mutex);
+        signal.notEmpty.wait(lock, [&] {
+            return queue.size() > 0 || counters[stage - 1].activeWorkers.load(std::memory_order_acquire) == 0;
+        });
+    }
+}
+
+void PuzzlePipeline::process(int stage, PipelineJob& job) const {
+    switch (stage) {
+        case GENERATE_STAGE:
+            job.puzzle.reset(new TurnPuzzle(settings.gridSize, job.result.filePrefix, job.discard));
+            job.puzzle->setSeed(job.result.seed);
+            job.puzzle->setBranchStrategy(settings.branchStrategy);
+            job.puzzle->setIncrementalSearch(settings.incrementalSearch);
+            job.puzzle->setSolverEngine(settings.solverEngine);
+            job.puzzle->setProbeBudget(settings.probeBudget);
+            job.puzzle->setSolutionCounting(settings.solutionCounting);
+            job.puzzle->generateSolution();
+            break;
+        case MARK_STAGE:
+            job.puzzle->markCells();
+            job.puzzle->exportToSVG(job.result.filePrefix + "solution.svg");
+            job.result.covered = job.puzzle->isSolutionCovered();
+            break;
+        case VERIFY_STAGE:
+            // A puzzle without a solution is only passed on to be reported
+            if (!job.result.covered) {
+                break;
+            }
+            // Only puzzles being verified hold a table, not the ones waiting in the queues
+            job.puzzle->setTranspositionMemory(settings.transpositionMegabytes);
+            job.puzzle->solvePuzzle();
+            job.puzzle->setTranspositionMemory(0);
+            job.result.walls = job.puzzle->getWallCount();
+            job.result.searchNodes = job.puzzle->getSearchNodes();
+            break;
+        case EXPORT_STAGE:
+            if (!job.result.covered) {
+                break;
+            }
+            job.puzzle->exportProblem();
+            PuzzleCorpus::pack(*job.puzzle, job.result.record);
+            break;
+    }
+}
+
+void PuzzlePipeline::passOn(int stage, std::unique_ptr<PipelineJob>& job) {
+    if (stage == EXPORT_STAGE) {
+        // Every slot of results is written by exactly one thread
+        results[job->result.index] = job->result;
+        job.reset();
+        return;
+    }
+
+    JobQueue& queue = *queues[stage + 1];
+    QueueSignal& signal = signals[stage + 1];
+    while (!queue.tryPush(job)) {
+        // Park until the next stage takes a job
+        std::unique_lock<std::mutex> lock(signal.mutex);
+        signal.notFull.wait(lock, [&] { return queue.size() < queue.getCapacity(); });
+    }
+    notify(signal, signal.notEmpty, false);
+}
+
+void PuzzlePipeline::notify(QueueSignal& signal, std::condition_variable& condition, bool all) {
+    // Taking the mutex orders this after a waiter's check, so the notification can not be missed
+    {
+        std::lock_guard<std::mutex> lock(signal.mutex);
+    }
+    if (all) {
+        condition.notify_all();
+    } else {
+        condition.notify_one();
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef PUZZLEPIPELINE_H
+#define PUZZLEPIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "BatchGenerator.h"
+#include "BoundedQueue.h"
+
+// Stages a pipelined puzzle passes through, in order
+enum PipelineStage {
+    GENERATE_STAGE = 0,  // generateSolution
+    MARK_STAGE,          // markCells, then export solution.svg
+    VERIFY_STAGE,        // solvePuzzle adds walls until the solution is unique
+    EXPORT_STAGE,        // export problem.svg and pack the corpus record
+    STAGE_COUNT
+};
+
+// Measured by PuzzlePipeline::run for one stage
+struct StageMetrics {
+    const char* name;
+    int workers;
+    long long puzzles;         // Puzzles the stage finished
+    double busySeconds;        // Time the stage's workers spent on puzzles, summed over workers
+    double puzzlesPerSecond;   // Per second of the whole run; the same for every stage once all puzzles are done
+    double capacityPerSecond;  // Puzzles per second the stage's workers could finish if never idle
+    size_t maxQueueDepth;      // Puzzles in the input queue whenever a worker takes one, that one included
+    double averageQueueDepth;
+};
+
+// A batch (see BatchGenerator) run as a pipeline of stages connected by bounded queues.
+// Every stage has its own workers, so the cheap stages keep producing while the uniqueness search
+// runs. Puzzles are seeded exactly as in BatchGenerator, so both give the same results.
+class PuzzlePipeline {
+public:
+    static const size_t DEFAULT_QUEUE_CAPACITY = 16;
+
+    PuzzlePipeline(const BatchSettings& settings, const int (&stageWorkers)[STAGE_COUNT],
+                   size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+    ~PuzzlePipeline();
+
+    // Results are in puzzle order
+    std::vector<BatchResult> run();
+
+    // Metrics of the last run(), in stage order
+    std::vector<StageMetrics> getMetrics() const;
+
+private:
+    struct PipelineJob;
+    typedef BoundedQueue<std::unique_ptr<PipelineJob>> JobQueue;
+
+    struct StageCounters {
+        std::atomic<int> activeWorkers;  // Workers that may still push to the next queue
+        std::atomic<long long> puzzles;
+        std::atomic<long long> busyNanoseconds;
+        std::atomic<long long> depthSum;
+        std::atomic<long long> depthSamples;
+        std::atomic<size_t> maxDepth;
+    };
+
+    // Where workers park while a queue is empty or full. The queue itself stays lock-free; the
+    // mutex only orders a waiter's check against the notification that follows a push or pop.
+    struct QueueSignal {
+        std::mutex mutex;
+        std::condition_variable notEmpty;  // Also signalled when the previous stage finishes
+        std::condition_variable notFull;
+    };
+
+    BatchSettings settings;
+    int workers[STAGE_COUNT];
+    std::unique_ptr<JobQueue> queues[STAGE_COUNT];  // queues[s] feeds stage s, none for GENERATE_STAGE
+    QueueSignal signals[STAGE_COUNT];                // Signals of queues[s]
+    StageCounters counters[STAGE_COUNT];
+    std::atomic<int> nextIndex;  // Next puzzle the generate stage starts
+    std::vector<BatchResult> results;
+    double runSeconds;
+
+    void workerLoop(int stage);
+    bool takeJob(int stage, std::unique_ptr<PipelineJob>& job);  // False once the stage has nothing left
+    void process(int stage, PipelineJob& job) const;
+    void passOn(int stage, std::unique_ptr<PipelineJob>& job);  // Hand to the next stage, waiting while it is full
+    static void notify(QueueSignal& signal, std::condition_variable& condition, bool all);
+};
+
+#endif // PUZZLEPIPELINE_H
@@ -0,0 +1,224 @@
+#include "SolutionCounter.h"
+#include <limits>
+#include "TurnPuzzle.h"
+
+namespace {
+
+// A frontier slot is one byte: 0 for no path, otherwise label | turns << 4 | end << 6.
+// end is what the path's other end is; OPEN_END paths have their other end in the slot with
+// the same label. turns are the turns made walking from the other end towards this slot.
+const uint8_t OPEN_END = 0;
+const uint8_t HEAD_END = 1;
+const uint8_t TAIL_END = 2;
+
+const uint8_t LEFT_TURN = 1;
+const uint8_t RIGHT_TURN = 2;
+const uint8_t MIXED_TURNS = LEFT_TURN | RIGHT_TURN;
+
+uint8_t makeSlot(uint8_t label, uint8_t turns, uint8_t end) {
+    return label | turns << 4 | end << 6;
+}
+
+uint8_t slotLabel(uint8_t slot) {
+    return slot & 15;
+}
+
+uint8_t slotTurns(uint8_t slot) {
+    return (slot >> 4) & 3;
+}
+
+uint8_t slotEnd(uint8_t slot) {
+    return slot >> 6;
+}
+
+// The same turns seen walking the other way
+uint8_t mirrorTurns(uint8_t turns) {
+    return ((turns & LEFT_TURN) ? RIGHT_TURN : 0) | ((turns & RIGHT_TURN) ? LEFT_TURN : 0);
+}
+
+// Turn made by moving in direction in and then in direction out, as TurnSignature sees it
+uint8_t turnBetween(TurnPuzzleTypes::Direction in, TurnPuzzleTypes::Direction out) {
+    TurnSignature signature;
+    signature.addStep(in);
+    signature.addStep(out);
+    return (signature.hasLeftTurn ? LEFT_TURN : 0) | (signature.hasRightTurn ? RIGHT_TURN : 0);
+}
+
+// A finished path needs a HEAD at exactly one end
+bool isHeadTailPair(uint8_t first, uint8_t second) {
+    return (first == HEAD_END && second == TAIL_END) || (first == TAIL_END && second == HEAD_END);
+}
+
+// Slot holding the other end of the open path with the given label
+int findPartner(const std::string& state, uint8_t label) {
+    for (size_t i = 0; i < state.size(); i++) {
+        uint8_t slot = state[i];
+        if (slot != 0 && slotEnd(slot) == OPEN_END && slotLabel(slot) == label) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Number the labels in order of appearance, so equal frontiers have equal keys
+void normalizeLabels(std::string& state) {
+    uint8_t mapping[16] = {};
+    uint8_t nextLabel = 1;
+    for (char& slot : state) {
+        uint8_t value = slot;
+        if (value == 0 || slotEnd(value) != OPEN_END) {
+            continue;
+        }
+        uint8_t& label = mapping[slotLabel(value)];
+        if (label == 0) {
+            label = nextLabel++;
+        }
+        slot = makeSlot(label, slotTurns(value), OPEN_END);
+    }
+}
+
+uint64_t addCapped(uint64_t first, uint64_t second) {
+    uint64_t sum = first + second;
+    return sum < first ? std::numeric_limits<uint64_t>::max() : sum;
+}
+
+} // namespace
+
+SolutionCounter::SolutionCounter(const TurnPuzzle& puzzle)
+    : gridSize(puzzle.gridSize), peakStates(0) {
+    const int cellCount = gridSize * gridSize;
+    head.assign(cellCount, false);
+    rightOpen.assign(cellCount, false);
+    downOpen.assign(cellCount, false);
+
+    for (const Cell* cell : puzzle.cells) {
+        head[cell->id] = cell->cellType == HEAD;
+        Edge* right = puzzle.getEdge(cell->row, cell->col, TurnPuzzleTypes::RIGHT);
+        Edge* down = puzzle.getEdge(cell->row, cell->col, TurnPuzzleTypes::DOWN);
+        rightOpen[cell->id] = right != nullptr && !right->isDeleted();
+        downOpen[cell->id] = down != nullptr && !down->isDeleted();
+    }
+}
+
+uint64_t SolutionCounter::count() {
+    // Slots 0 .. gridSize - 1 are the columns, slot gridSize the edge right of the newest cell
+    Frontier current;
+    Frontier next;
+    current.emplace(std::string(gridSize + 1, '\0'), 1);
+    peakStates = 1;
+
+    for (int row = 0; row < gridSize; row++) {
+        for (int col = 0; col < gridSize; col++) {
+            next.clear();
+            for (const auto& entry : current) {
+                addCell(row, col, entry.first, entry.second, next);
+            }
+            current.swap(next);
+            if (current.size() > peakStates) {
+                peakStates = current.size();
+            }
+        }
+    }
+
+    // Every path has to be finished once the last cell is added
+    auto done = current.find(std::string(gridSize + 1, '\0'));
+    return done != current.end() ? done->second : 0;
+}
+
+size_t SolutionCounter::getPeakStates() const {
+    return peakStates;
+}
+
+void SolutionCounter::addCell(int row, int col, const std::string& state, uint64_t ways, Frontier& next) const {
+    const int cell = row * gridSize + col;
+    const int rightSlot = gridSize;
+    const uint8_t up = state[col];
+    const uint8_t left = state[rightSlot];
+    const uint8_t cellEnd = head[cell] ? HEAD_END : TAIL_END;
+    const int existing = (up != 0) + (left != 0);
+
+    for (int choice = 0; choice < 4; choice++) {
+        const bool useRight = choice & 1;
+        const bool useDown = choice & 2;
+        if ((useRight && !rightOpen[cell]) || (useDown && !downOpen[cell])) {
+            continue;
+        }
+
+        // HEAD cells end a path, UNMARKED cells continue it or are its tail
+        const int degree = existing + useRight + useDown;
+        if (degree == 0 || degree > 2 || (head[cell] && degree != 1)) {
+            continue;
+        }
+
+        std::string result = state;
+        result[col] = 0;
+        result[rightSlot] = 0;
+
+        if (existing == 0) {
+            if (degree == 1) {
+                // A path starts here
+                result[useRight ? rightSlot : col] = makeSlot(0, 0, cellEnd);
+            } else {
+                // A corner whose two ends both stay open; label 15 is free until normalizeLabels
+                uint8_t turns = turnBetween(TurnPuzzleTypes::UP, TurnPuzzleTypes::RIGHT);
+                result[rightSlot] = makeSlot(15, turns, OPEN_END);
+                result[col] = makeSlot(15, mirrorTurns(turns), OPEN_END);
+            }
+        } else if (existing == 1) {
+            const uint8_t end = up != 0 ? up : left;
+            const TurnPuzzleTypes::Direction in = up != 0 ? TurnPuzzleTypes::DOWN : TurnPuzzleTypes::RIGHT;
+            const int partner = slotEnd(end) == OPEN_END ? findPartner(result, slotLabel(end)) : -1;
+
+            if (degree == 1) {
+                // The path ends here
+                if (partner == -1) {
+                    if (!isHeadTailPair(slotEnd(end), cellEnd)) {
+                        continue;
+                    }
+                } else {
+                    result[partner] = makeSlot(0, slotTurns(result[partner]), cellEnd);
+                }
+            } else {
+                // The path runs on through this cell
+                const TurnPuzzleTypes::Direction out = useRight ? TurnPuzzleTypes::RIGHT : TurnPuzzleTypes::DOWN;
+                uint8_t turns = slotTurns(end) | turnBetween(in, out);
+                if (turns == MIXED_TURNS) {
+                    continue;
+                }
+                result[useRight ? rightSlot : col] = makeSlot(slotLabel(end), turns, slotEnd(end));
+                if (partner != -1) {
+                    result[partner] = makeSlot(slotLabel(end), mirrorTurns(turns), OPEN_END);
+                }
+            }
+        } else {
+            // Two paths meet here; walking from the upper one into the left one
+            if (slotEnd(up) == OPEN_END && slotEnd(left) == OPEN_END && slotLabel(up) == slotLabel(left)) {
+                continue;  // Closed loop
+            }
+            uint8_t turns = slotTurns(up) | turnBetween(TurnPuzzleTypes::DOWN, TurnPuzzleTypes::LEFT) |
+                            mirrorTurns(slotTurns(left));
+            if (turns == MIXED_TURNS) {
+                continue;
+            }
+
+            const int upPartner = slotEnd(up) == OPEN_END ? findPartner(result, slotLabel(up)) : -1;
+            const int leftPartner = slotEnd(left) == OPEN_END ? findPartner(result, slotLabel(left)) : -1;
+            if (upPartner == -1 && leftPartner == -1) {
+                if (!isHeadTailPair(slotEnd(up), slotEnd(left))) {
+                    continue;
+                }
+            } else if (upPartner == -1) {
+                result[leftPartner] = makeSlot(0, turns, slotEnd(up));
+            } else if (leftPartner == -1) {
+                result[upPartner] = makeSlot(0, mirrorTurns(turns), slotEnd(left));
+            } else {
+                result[leftPartner] = makeSlot(slotLabel(up), turns, OPEN_END);
+                result[upPartner] = makeSlot(slotLabel(up), mirrorTurns(turns), OPEN_END);
+            }
+        }
+
+        normalizeLabels(result);
+        uint64_t& total = next[result];
+        total = addCapped(total, ways);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef SOLUTIONCOUNTER_H
+#define SOLUTIONCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward declaration
+class TurnPuzzle;
+
+// Exact solution count by a row-by-row transfer-matrix (frontier) sweep.
+// Cells are added in row-major order. The frontier holds one slot per column for the edge
+// below the newest cell of that column, plus one slot for the edge right of the newest cell.
+// A slot that carries a path records what the path looks like from there: whether its other end
+// is also on the frontier (a label pairs the two slots) or ended at a HEAD or a tail, and the
+// turns seen walking towards the slot. Partial solutions with equal frontiers are merged, so the
+// work grows linearly with the height and only the frontier grows with the width.
+// Only HEAD markers and DELETED walls are taken from the puzzle; other edge states are ignored.
+class SolutionCounter {
+public:
+    static const int MAX_WIDTH = 16;
+
+    explicit SolutionCounter(const TurnPuzzle& puzzle);
+
+    // Number of solutions, capped at the largest uint64_t
+    uint64_t count();
+    size_t getPeakStates() const;  // Most frontier states alive at once during the last count()
+
+private:
+    typedef std::unordered_map<std::string, uint64_t> Frontier;
+
+    int gridSize;
+    std::vector<char> head;       // Per cell
+    std::vector<char> rightOpen;  // Per cell: the edge to the right exists and is not DELETED
+    std::vector<char> downOpen;   // Per cell: the edge below exists and is not DELETED
+    size_t peakStates;
+
+    // Add every way of completing cell (row, col) to one frontier state
+    void addCell(int row, int col, const std::string& state, uint64_t ways, Frontier& next) const;
+};
+
+#endif // SOLUTIONCOUNTER_H
@@ -0,0 +1,268 @@
+#include "StreamSolver.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include "PuzzleCorpus.h"
+#include "TurnPuzzle.h"
+
+static const int MAX_GRID_SIZE = 256;
+
+// Skip spaces and tabs
+static const char* skipBlanks(const char* text) {
+    while (*text == ' ' || *text == '\t' || *text == '\r') {
+        text++;
+    }
+    return text;
+}
+
+// Read a number, false if there is none
+static bool readNumber(const char*& text, int& value) {
+    char* end;
+    long number = std::strtol(text, &end, 10);
+    if (end == text || number < 0 || number > 1 << 20) {
+        return false;
+    }
+    value = static_cast<int>(number);
+    text = end;
+    return true;
+}
+
+// Read "<row>,<col>" of a cell inside the grid
+static bool readCell(const char*& text, int gridSize, int& row, int& col) {
+    return readNumber(text, row) && *text++ == ',' && readNumber(text, col) && row < gridSize && col < gridSize;
+}
+
+// Id of the edge to the right of (R) or below (D) a cell, -1 if there is none. Edges are numbered
+// as in TurnPuzzle::getEdge: horizontal edges row by row, then vertical edges.
+static int wallEdgeId(int gridSize, int row, int col, char side) {
+    if (side == 'R' && col < gridSize - 1) {
+        return row * (gridSize - 1) + col;
+    }
+    if (side == 'D' && row < gridSize - 1) {
+        return gridSize * (gridSize - 1) + row * gridSize + col;
+    }
+    return -1;
+}
+
+StreamSolver::StreamSolver(std::ostream& output)
+    : output(output), discard(nullptr),
+      branchStrategy(TurnPuzzleTypes::BranchStrategy::FIRST_UNDECIDED), searchThreads(1),
+      solverEngine(TurnPuzzleTypes::SolverEngine::OBJECT_GRAPH), transpositionMegabytes(16), probeBudget(0),
+      unique(0) {
+}
+
+StreamSolver::~StreamSolver() {
+}
+
+void StreamSolver::setBranchStrategy(TurnPuzzleTypes::BranchStrategy strategy) {
+    branchStrategy = strategy;
+}
+
+void StreamSolver::setSearchThreads(int threads) {
+    searchThreads = threads;
+}
+
+void StreamSolver::setSolverEngine(TurnPuzzleTypes::SolverEngine engine) {
+    solverEngine = engine;
+}
+
+void StreamSolver::setTranspositionMemory(size_t megabytes) {
+    transpositionMegabytes = megabytes;
+}
+
+void StreamSolver::setProbeBudget(int edgesPerNode) {
+    probeBudget = edgesPerNode;
+}
+
+long long StreamSolver::getUnique() const {
+    return unique;
+}
+
+long long StreamSolver::run(std::istream& input) {
+    unique = 0;
+    if (input.peek() == 'T') {
+        return runBinary(input);
+    }
+    return runText(input);
+}
+
+long long StreamSolver::run(const std::string& path) {
+    if (path == "-") {
+        return run(std::cin);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return -1;
+    }
+    if (file.peek() != 'T') {
+        return run(file);
+    }
+
+    // Corpus files are mapped and their records read in place
+    file.close();
+    PuzzleCorpusReader corpus;
+    if (!corpus.open(path)) {
+        return -1;
+    }
+    unique = 0;
+    return runCorpus(corpus);
+}
+
+long long StreamSolver::runText(std::istream& input) {
+    long long index = 0;
+    while (std::getline(input, line)) {
+        const char* text = skipBlanks(line.c_str());
+        if (*text == '\0' || *text == '#') {
+            continue;
+        }
+        int gridSize;
+        if (parseLine(gridSize)) {
+            solve(index, gridSize);
+        } else {
+            reportInvalid(index);
+        }
+        index++;
+    }
+    return index;
+}
+
+long long StreamSolver::runBinary(std::istream& input) {
+    int gridSize;
+    if (!PuzzleCorpus::readHeader(input, gridSize)) {
+        std::cerr << "Input is not a puzzle corpus" << std::endl;
+        return -1;
+    }
+
+    record.resize(PuzzleCorpus::recordSize(gridSize));
+    long long index = 0;
+    while (input.read(reinterpret_cast<char*>(record.data()), record.size())) {
+        if (parseRecord(record.data(), gridSize)) {
+            solve(index, gridSize);
+        } else {
+            reportInvalid(index);
+        }
+        index++;
+    }
+    return index;
+}
+
+bool StreamSolver::parseLine(int& gridSize) {
+    headCells.clear();
+    wallEdges.clear();
+    const char* text = skipBlanks(line.c_str());
+    if (!readNumber(text, gridSize) || gridSize < 2 || gridSize > MAX_GRID_SIZE) {
+        error = "bad grid size";
+        return false;
+    }
+    text = skipBlanks(text);
+    if (*text++ != ';') {
+        error = "expected ';' after the grid size";
+        return false;
+    }
+
+    // HEAD cells up to the next ';'
+    int row;
+    int col;
+    while (*(text = skipBlanks(text)) != ';') {
+        if (!readCell(text, gridSize, row, col)) {
+            error = "bad HEAD cell";
+            return false;
+        }
+        headCells.push_back(row * gridSize + col);
+    }
+    text++;
+
+    // Walls up to the end of the line; the puzzle is only fetched once the whole line is valid
+    while (*(text = skipBlanks(text)) != '\0') {
+        if (!readCell(text, gridSize, row, col) || *text++ != ',') {
+            error = "bad wall";
+            return false;
+        }
+        int edgeId = wallEdgeId(gridSize, row, col, *text++);
+        if (edgeId < 0) {
+            error = "bad wall";
+            return false;
+        }
+        wallEdges.push_back(edgeId);
+    }
+    return true;
+}
+
+long long StreamSolver::runCorpus(const PuzzleCorpusReader& corpus) {
+    int gridSize = corpus.getGridSize();
+    long long count = static_cast<long long>(corpus.size());
+    for (long long index = 0; index < count; index++) {
+        if (parseRecord(corpus.getRecord(index), gridSize)) {
+            solve(index, gridSize);
+        } else {
+            reportInvalid(index);
+        }
+    }
+    return count;
+}
+
+bool StreamSolver::parseRecord(const unsigned char* record, int gridSize) {
+    headCells.clear();
+    wallEdges.clear();
+    if ((record[0] | (record[1] << 8)) != gridSize) {
+        error = "record of another grid size";
+        return false;
+    }
+
+    const unsigned char* heads = record + 2;
+    const unsigned char* walls = heads + (gridSize * gridSize + 7) / 8;
+    for (int cell = 0; cell < gridSize * gridSize; cell++) {
+        if (PuzzleCorpus::getBit(heads, cell)) {
+            headCells.push_back(cell);
+        }
+    }
+    for (int edge = 0; edge < PuzzleCorpus::edgeCount(gridSize); edge++) {
+        if (PuzzleCorpus::getBit(walls, edge)) {
+            wallEdges.push_back(edge);
+        }
+    }
+    return true;
+}
+
+TurnPuzzle& StreamSolver::puzzleOfSize(int gridSize) {
+    if (puzzle == nullptr || puzzle->getSize() != gridSize) {
+        // The per-node debug log would cost more than the search itself
+        puzzle.reset(new TurnPuzzle(gridSize, "", discard, false));
+        puzzle->setBranchStrategy(branchStrategy);
+        puzzle->setSearchThreads(searchThreads);
+        puzzle->setSolverEngine(solverEngine);
+        puzzle->setTranspositionMemory(transpositionMegabytes);
+        puzzle->setProbeBudget(probeBudget);
+    }
+    return *puzzle;
+}
+
+void StreamSolver::solve(long long index, int gridSize) {
+    auto start = std::chrono::steady_clock::now();
+    TurnPuzzle& target = puzzleOfSize(gridSize);
+    target.loadPuzzle(headCells, wallEdges);
+    int found = target.checkUniqueness(solution);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    static const char* const VERDICTS[] = {"none", "unique", "multiple"};
+    output << index << " " << VERDICTS[found] << " " << target.getSearchNodes() << " " << milliseconds;
+    if (found > 0) {
+        for (size_t i = 0; i < solution.size(); i++) {
+            if (solution[i] == INCLUDED) {
+                const Edge* edge = target.edges[i];
+                output << " " << edge->cell1->row << "," << edge->cell1->col << ","
+                       << (edge->cell2->row == edge->cell1->row ? 'R' : 'D');
+            }
+        }
+    }
+    output << "\n";
+    if (found == 1) {
+        unique++;
+    }
+}
+
+void StreamSolver::reportInvalid(long long index) {
+    output << index << " invalid 0 0 # " << error << "\n";
+}
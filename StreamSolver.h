@@ -0,0 +1,77 @@
+#ifndef STREAMSOLVER_H
+#define STREAMSOLVER_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DataTypes.h"
+#include "Edge.h"
+
+// Forward declarations
+class TurnPuzzle;
+class PuzzleCorpusReader;
+
+// Checks a stream of puzzles given by their HEAD cells and walls, and writes one result line per puzzle.
+//
+// Input is either a binary corpus (see PuzzleCorpus; the solution bits are ignored) or text with one
+// puzzle per line:
+//     <size> ; <row>,<col> ... ; <row>,<col>,<R|D> ...
+// The middle part lists the HEAD cells and the last part the walls, each given as the edge to the
+// right of (R) or below (D) a cell. Empty lines and lines starting with '#' are skipped.
+//
+// Output lines are:
+//     <index> <none|unique|multiple|invalid> <search nodes> <milliseconds> <solution edges>
+// with the edges of the first solution found in the wall format.
+//
+// One TurnPuzzle is kept per grid size and loaded again for every puzzle, so long runs of puzzles
+// of one size allocate nothing per puzzle.
+class StreamSolver {
+public:
+    explicit StreamSolver(std::ostream& output);
+    ~StreamSolver();
+
+    // Search settings of the puzzles; kept for puzzles created later
+    void setBranchStrategy(TurnPuzzleTypes::BranchStrategy strategy);
+    void setSearchThreads(int threads);
+    void setSolverEngine(TurnPuzzleTypes::SolverEngine engine);
+    void setTranspositionMemory(size_t megabytes);
+    void setProbeBudget(int edgesPerNode);
+
+    // Returns the number of puzzles read, or -1 if the input is not readable
+    long long run(std::istream& input);
+    // Same for a file, "-" for stdin; a corpus file is memory-mapped with PuzzleCorpusReader
+    long long run(const std::string& path);
+
+    long long getUnique() const;
+
+private:
+    std::ostream& output;
+    std::ostream discard;  // Console of the puzzles
+    std::unique_ptr<TurnPuzzle> puzzle;
+    TurnPuzzleTypes::BranchStrategy branchStrategy;
+    int searchThreads;
+    TurnPuzzleTypes::SolverEngine solverEngine;
+    size_t transpositionMegabytes;
+    int probeBudget;
+    long long unique;
+
+    // Reused for every puzzle
+    std::vector<int> headCells;
+    std::vector<int> wallEdges;
+    std::vector<EdgeState> solution;
+    std::vector<unsigned char> record;  // Binary input read from a stream
+    std::string line;
+    std::string error;
+
+    long long runText(std::istream& input);
+    long long runBinary(std::istream& input);
+    long long runCorpus(const PuzzleCorpusReader& corpus);
+    bool parseLine(int& gridSize);  // False, with error set, if the line is not a valid puzzle
+    bool parseRecord(const unsigned char* record, int gridSize);
+    TurnPuzzle& puzzleOfSize(int gridSize);
+    void solve(long long index, int gridSize);
+    void reportInvalid(long long index);
+};
+
+#endif // STREAMSOLVER_H
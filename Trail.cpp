@@ -0,0 +1,25 @@
+#include "Trail.h"
+
+void Trail::record(Edge* edge, EdgeState oldState) {
+    entries.push_back({edge, oldState});
+}
+
+size_t Trail::size() const {
+    return entries.size();
+}
+
+const Trail::Entry& Trail::getEntry(size_t index) const {
+    return entries[index];
+}
+
+void Trail::undoTo(size_t mark) {
+    while (entries.size() > mark) {
+        const Entry& entry = entries.back();
+        entry.edge->applyState(entry.oldState);
+        entries.pop_back();
+    }
+}
+
+void Trail::clear() {
+    entries.clear();
+}
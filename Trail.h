@@ -0,0 +1,36 @@
+#ifndef TRAIL_H
+#define TRAIL_H
+
+#include <cstddef>
+#include <vector>
+#include "Edge.h"
+
+// A branching decision taken by the solver search
+struct SearchDecision {
+    int edgeId;
+    EdgeState state;
+};
+
+// Undo log for the solver search.
+// While attached to the edges, every Edge::setState call appends the edge's previous
+// state, so backtracking only has to revert the edges changed since a decision point.
+class Trail {
+public:
+    struct Entry {
+        Edge* edge;
+        EdgeState oldState;
+    };
+
+    void record(Edge* edge, EdgeState oldState);
+    size_t size() const;
+    const Entry& getEntry(size_t index) const;
+
+    // Revert every change recorded after mark, newest first
+    void undoTo(size_t mark);
+    void clear();
+
+private:
+    std::vector<Entry> entries;
+};
+
+#endif // TRAIL_H
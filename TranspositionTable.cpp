@@ -0,0 +1,126 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable()
+    : bucketMask(0), probes(0), hits(0), stores(0), replacements(0) {
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    // Largest power-of-two bucket count that fits the budget
+    size_t buckets = megabytes * 1024 * 1024 / (BUCKET_SIZE * sizeof(Entry));
+    size_t power = 0;
+    if (buckets > 0) {
+        power = 1;
+        while (power * 2 <= buckets) {
+            power *= 2;
+        }
+    }
+
+    entries.assign(power * BUCKET_SIZE, Entry());
+    entries.shrink_to_fit();
+    usedBuckets.clear();
+    bucketMask = power > 0 ? power - 1 : 0;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    // Only buckets that were written need wiping, which keeps clearing cheap for easy puzzles
+    for (size_t index : usedBuckets) {
+        Entry* first = &entries[index * BUCKET_SIZE];
+        for (size_t i = 0; i < BUCKET_SIZE; i++) {
+            first[i] = Entry();
+        }
+    }
+    usedBuckets.clear();
+    probes = 0;
+    hits = 0;
+    stores = 0;
+    replacements = 0;
+}
+
+bool TranspositionTable::isEnabled() const {
+    return !entries.empty();
+}
+
+bool TranspositionTable::contains(uint64_t key) {
+    probes++;
+    key = storedKey(key);
+    Entry* first = bucket(key);
+    for (size_t i = 0; i < BUCKET_SIZE; i++) {
+        if (first[i].key == key) {
+            hits++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, long long searchNodes) {
+    stores++;
+    key = storedKey(key);
+    Entry* first = bucket(key);
+
+    // Reuse the state's own entry wherever it is in the bucket, so a state never takes two slots
+    Entry* target = nullptr;
+    for (size_t i = 0; i < BUCKET_SIZE; i++) {
+        if (first[i].key == key) {
+            target = &first[i];
+            break;
+        }
+    }
+
+    // Otherwise take an empty entry, or replace the cheapest proof
+    if (target == nullptr) {
+        target = &first[0];
+        for (size_t i = 0; i < BUCKET_SIZE; i++) {
+            if (first[i].key == 0) {
+                target = &first[i];
+                break;
+            }
+            if (first[i].searchNodes < target->searchNodes) {
+                target = &first[i];
+            }
+        }
+    }
+
+    // Empty entries are taken in order, so a bucket is new if its first entry is
+    if (first[0].key == 0) {
+        usedBuckets.push_back((first - entries.data()) / BUCKET_SIZE);
+    }
+    if (target->key != 0 && target->key != key) {
+        replacements++;
+    }
+    if (target->key == key && target->searchNodes > searchNodes) {
+        return;
+    }
+    target->key = key;
+    target->searchNodes = searchNodes;
+}
+
+long long TranspositionTable::getProbes() const {
+    return probes;
+}
+
+long long TranspositionTable::getHits() const {
+    return hits;
+}
+
+long long TranspositionTable::getStores() const {
+    return stores;
+}
+
+long long TranspositionTable::getReplacements() const {
+    return replacements;
+}
+
+size_t TranspositionTable::getCapacity() const {
+    return entries.size();
+}
+
+TranspositionTable::Entry* TranspositionTable::bucket(uint64_t key) {
+    // The low bits pick the bucket; the full key is compared inside it
+    return &entries[(key & bucketMask) * BUCKET_SIZE];
+}
+
+uint64_t TranspositionTable::storedKey(uint64_t key) {
+    return key == 0 ? 1 : key;
+}
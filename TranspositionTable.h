@@ -0,0 +1,49 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Search states proven to have no different solution, keyed by the Zobrist hash of their edge
+// states. The table has a fixed memory budget: entries live in buckets of four, and a full bucket
+// gives up the entry whose proof took the fewest search nodes, which is the cheapest to redo.
+class TranspositionTable {
+public:
+    TranspositionTable();
+
+    // Allocate up to the given number of megabytes and clear the table; 0 disables it
+    void resize(size_t megabytes);
+    void clear();  // Forget every state and reset the counters, in time proportional to the states stored
+    bool isEnabled() const;
+
+    bool contains(uint64_t key);  // Counted as a probe
+    void store(uint64_t key, long long searchNodes);  // searchNodes is what proving the state cost
+
+    long long getProbes() const;
+    long long getHits() const;
+    long long getStores() const;
+    long long getReplacements() const;  // Stores that pushed out another state
+    size_t getCapacity() const;
+
+private:
+    static const size_t BUCKET_SIZE = 4;
+
+    struct Entry {
+        uint64_t key;  // 0 marks an empty entry
+        long long searchNodes;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<size_t> usedBuckets;  // Buckets holding an entry, so clear() only wipes those
+    size_t bucketMask;
+    long long probes;
+    long long hits;
+    long long stores;
+    long long replacements;
+
+    Entry* bucket(uint64_t key);
+    static uint64_t storedKey(uint64_t key);  // Keeps 0 free for empty entries
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -5,14 +5,28 @@
 #include <algorithm>
 #include <queue>
 #include <set>
+#include <cstdlib>
+#include "BitboardEngine.h"
+#include "SolutionCounter.h"
 #include "DataTypes.h"
 
 // Constructor
-TurnPuzzle::TurnPuzzle(int size) : gridSize(size) {
-    std::cout << "TurnPuzzle created with grid size: " << gridSize << "x" << gridSize << std::endl;
+TurnPuzzle::TurnPuzzle(int size, const std::string& filePrefix, std::ostream& output, bool debugLog)
+    : gridSize(size), outputPrefix(filePrefix), console(&output), seed(42), seeded(false),
+      visitGeneration(1), propagationCursor(0),
+      certainTails(0), possibleTails(0), headCount(0), reasonCursor(0), conflictReason(0), stateHash(0),
+      branchStrategy(TurnPuzzleTypes::BranchStrategy::FIRST_UNDECIDED), branchRng(42),
+      searchNodes(0), probeBudget(0), probeCount(0), attemptStartNodes(0), nodeLimit(0), searchAborted(false),
+      searchThreads(1), workerCopy(false), parallelSearch(nullptr), workerIndex(0),
+      incrementalSearch(false), solutionCounting(false), solutionExport(true),
+      solverEngine(TurnPuzzleTypes::SolverEngine::OBJECT_GRAPH),
+      pendingWall(nullptr), pendingWallPosition(0), wallMark(0) {
+    *console << "TurnPuzzle created with grid size: " << gridSize << "x" << gridSize << std::endl;
     
     // Open log file
-    logFile.open("debug.log", std::ios::out | std::ios::trunc);
+    if (debugLog) {
+        logFile.open(outputPrefix + "debug.log", std::ios::out | std::ios::trunc);
+    }
     if (logFile.is_open()) {
         logFile << "=== Turn Puzzle Debug Log ===" << std::endl;
         logFile << "Grid size: " << gridSize << "x" << gridSize << std::endl;
@@ -22,47 +36,106 @@ TurnPuzzle::TurnPuzzle(int size) : gridSize(size) {
     initializeEdges();
 }
 
-// Destructor
-TurnPuzzle::~TurnPuzzle() {
-    // Clean up cells
-    for (Cell* cell : cells) {
-        delete cell;
-    }
+// Worker copy
+TurnPuzzle::TurnPuzzle(const TurnPuzzle& other, WorkerTag)
+    : gridSize(other.gridSize), outputPrefix(other.outputPrefix), console(other.console), seed(other.seed),
+      seeded(other.seeded), visitGeneration(1), originalSolution(other.originalSolution), propagationCursor(0),
+      certainTails(0), possibleTails(0), headCount(0), reasonCursor(0), conflictReason(0), stateHash(0),
+      branchStrategy(other.branchStrategy), branchRng(42),
+      searchNodes(0), probeBudget(other.probeBudget), probeCount(0), attemptStartNodes(0), nodeLimit(0),
+      searchAborted(false), searchThreads(1), workerCopy(true), parallelSearch(nullptr), workerIndex(0),
+      incrementalSearch(false), solutionCounting(false), solutionExport(true),
+      solverEngine(TurnPuzzleTypes::SolverEngine::OBJECT_GRAPH),
+      pendingWall(nullptr), pendingWallPosition(0), wallMark(0) {
+    initializeGrid();
+    initializeEdges();
     
-    // Clean up edges
-    for (Edge* edge : edges) {
-        delete edge;
+    for (size_t i = 0; i < cells.size(); i++) {
+        cells[i]->cellType = other.cells[i]->cellType;
     }
-    
+    for (size_t i = 0; i < edges.size(); i++) {
+        edges[i]->setState(other.edges[i]->state);
+    }
+    for (Edge* edge : other.branchOrder) {
+        branchOrder.push_back(edges[edge->id]);
+    }
+}
+
+// Destructor
+TurnPuzzle::~TurnPuzzle() {
     // Close log file
     if (logFile.is_open()) {
         logFile << "=== End of Log ===" << std::endl;
         logFile.close();
     }
     
-    std::cout << "TurnPuzzle destroyed" << std::endl;
+    if (!workerCopy) {
+        *console << "TurnPuzzle destroyed" << std::endl;
+    }
 }
 
 void TurnPuzzle::initializeGrid() {
-    // Create cells in flat array
-    cells.resize(gridSize * gridSize);
+    // Create cells in flat array; reserving first keeps the cell pointers stable
+    cellStorage.reserve(gridSize * gridSize);
     for (int i = 0; i < gridSize; i++) {
         for (int j = 0; j < gridSize; j++) {
-            cells[i * gridSize + j] = new Cell(i, j);
+            cellStorage.emplace_back(i, j, i * gridSize + j);
+            cells.push_back(&cellStorage.back());
         }
     }
+    cellQueued.assign(cells.size(), false);
 }
 
 Cell* TurnPuzzle::getCell(int row, int col) const {
     return cells[row * gridSize + col];
 }
 
+int TurnPuzzle::cellIndex(const Cell* cell) const {
+    return cell->id;
+}
+
+Edge* TurnPuzzle::getEdge(int row, int col, TurnPuzzleTypes::Direction direction) const {
+    // Horizontal edges come first, row by row, followed by the vertical edges
+    const int horizontalCount = gridSize * (gridSize - 1);
+    switch (direction) {
+        case TurnPuzzleTypes::RIGHT:
+            return col < gridSize - 1 ? edges[row * (gridSize - 1) + col] : nullptr;
+        case TurnPuzzleTypes::LEFT:
+            return col > 0 ? edges[row * (gridSize - 1) + col - 1] : nullptr;
+        case TurnPuzzleTypes::DOWN:
+            return row < gridSize - 1 ? edges[horizontalCount + row * gridSize + col] : nullptr;
+        case TurnPuzzleTypes::UP:
+            return row > 0 ? edges[horizontalCount + (row - 1) * gridSize + col] : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+Edge* TurnPuzzle::edgeBetween(const Cell* first, const Cell* second) const {
+    return getEdge(first->row, first->col, TurnSignature::directionBetween(first, second));
+}
+
 void TurnPuzzle::resetVisitedFlags() {
-    for (Cell* cell : cells) {
-        cell->visited = false;
+    // Every stamp from earlier traversals becomes stale at once
+    visitGeneration++;
+    
+    // Only after the counter wraps around do the stamps have to be cleared
+    if (visitGeneration == 0) {
+        for (Cell* cell : cells) {
+            cell->visitStamp = 0;
+        }
+        visitGeneration = 1;
     }
 }
 
+bool TurnPuzzle::isVisited(const Cell* cell) const {
+    return cell->visitStamp == visitGeneration;
+}
+
+void TurnPuzzle::markVisited(Cell* cell) {
+    cell->visitStamp = visitGeneration;
+}
+
 void TurnPuzzle::findPath(Cell* startCell, Path& path) {
     // If degree is 0, add just this cell
     if (startCell->getDegree() == 0) {
@@ -81,7 +154,7 @@ void TurnPuzzle::findPath(Cell* startCell, Path& path) {
         
         while (currentCell != nullptr) {
             // Mark as visited and add to path
-            currentCell->visited = true;
+            markVisited(currentCell);
             path.addCell(currentCell);
             
             // Find the next unvisited cell connected by an INCLUDED edge
@@ -91,7 +164,7 @@ void TurnPuzzle::findPath(Cell* startCell, Path& path) {
                     // Get the other cell
                     Cell* otherCell = (edge->cell1 == currentCell) ? edge->cell2 : edge->cell1;
                     
-                    if (!otherCell->visited) {
+                    if (!isVisited(otherCell)) {
                         nextCell = otherCell;
                         break;
                     }
@@ -104,54 +177,108 @@ void TurnPuzzle::findPath(Cell* startCell, Path& path) {
     }
 }
 
-bool TurnPuzzle::findPaths(std::vector<Path>& paths) {
-    // Clear the paths vector
-    paths.clear();
+int TurnPuzzle::walkHeadPath(Cell* head, TurnSignature& signature, Cell*& end, std::vector<int>* cellIndices) {
+    // Same rules as findPath: only cells with degree 0 or 1 start a path
+    end = head;
+    if (head->getDegree() > 1) {
+        return 0;
+    }
     
-    // Reset visited flags
     resetVisitedFlags();
-    
-    // Find all HEAD cells and trace paths from them
-    for (Cell* cell : cells) {
-        // If this is a HEAD cell, trace the path from it
-        if (cell->cellType == HEAD) {
-            Path path;
-            findPath(cell, path);
-            
-            // Only add non-empty paths
-            if (path.getLength() > 0) {
-                // Check if the last cell in the path is a HEAD cell
-                if (path.getLength() > 1) {
-                    Cell* lastCell = path.cells[path.getLength() - 1];
-                    if (lastCell->cellType == HEAD) {
-                        return false;  // Path ends with HEAD - invalid
-                    }
-                }
-                
-                // Calculate turn type and check if it's mixed
-                path.calculateTurnType();
-                if (path.turnType == RIGHT_LEFT_MIXED) {
-                    return false;
+    int length = 0;
+    Cell* currentCell = head;
+    while (currentCell != nullptr) {
+        markVisited(currentCell);
+        if (cellIndices != nullptr) {
+            cellIndices->push_back(currentCell->id);
+        }
+        length++;
+        end = currentCell;
+        
+        // Find the next unvisited cell connected by an INCLUDED edge
+        Cell* nextCell = nullptr;
+        for (Edge* edge : currentCell->edges) {
+            if (edge->isIncluded()) {
+                Cell* otherCell = (edge->cell1 == currentCell) ? edge->cell2 : edge->cell1;
+                if (!isVisited(otherCell)) {
+                    nextCell = otherCell;
+                    break;
                 }
-                
-                paths.push_back(path);
             }
-            
-            // Reset visited flags for next HEAD cell
-            resetVisitedFlags();
         }
+        
+        if (nextCell != nullptr) {
+            signature.addStep(TurnSignature::directionBetween(currentCell, nextCell));
+        }
+        currentCell = nextCell;
+    }
+    return length;
+}
+
+bool TurnPuzzle::tracePaths(PathBuffer& buffer) {
+    buffer.clear();
+    
+    for (Cell* cell : cells) {
+        if (cell->cellType != HEAD) {
+            continue;
+        }
+        
+        TurnSignature signature;
+        Cell* end = nullptr;
+        int length = walkHeadPath(cell, signature, end, &buffer.cellIndices);
+        if (length == 0) {
+            continue;
+        }
+        
+        // Paths may not end at another HEAD or turn both ways
+        if ((length > 1 && end->cellType == HEAD) || signature.getTurnType() == RIGHT_LEFT_MIXED) {
+            return false;
+        }
+        buffer.endPath();
     }
     
     return true;
 }
 
+PathValidation TurnPuzzle::validatePaths() {
+    PathValidation validation;
+    
+    for (Cell* cell : cells) {
+        if (cell->cellType != HEAD) {
+            continue;
+        }
+        
+        TurnSignature signature;
+        Cell* end = nullptr;
+        int length = walkHeadPath(cell, signature, end, nullptr);
+        
+        validation.headToHead = length > 1 && end->cellType == HEAD;
+        validation.mixedTurns = signature.getTurnType() == RIGHT_LEFT_MIXED;
+        if (!validation.isValid()) {
+            break;
+        }
+        validation.coveredCells += length;
+    }
+    
+    return validation;
+}
+
+bool TurnPuzzle::isSolutionCovered() {
+    // The generator can leave a cell without edges, and markCells gives no HEAD to such a cell
+    PathValidation validation = validatePaths();
+    return validation.isValid() && validation.coveredCells == static_cast<int>(cells.size());
+}
+
 void TurnPuzzle::initializeEdges() {
-    // Create all horizontal edges (connecting cells left-right)
+    // Create all horizontal edges (connecting cells left-right), then all vertical ones;
+    // getEdge() relies on this order
+    edgeStorage.reserve(2 * gridSize * (gridSize - 1));
     for (int row = 0; row < gridSize; row++) {
         for (int col = 0; col < gridSize - 1; col++) {
             Cell* cell1 = getCell(row, col);
             Cell* cell2 = getCell(row, col + 1);
-            Edge* edge = new Edge(cell1, cell2);
+            edgeStorage.emplace_back(cell1, cell2, edges.size());
+            Edge* edge = &edgeStorage.back();
             edges.push_back(edge);
             cell1->addEdge(edge);
             cell2->addEdge(edge);
@@ -163,15 +290,27 @@ void TurnPuzzle::initializeEdges() {
         for (int col = 0; col < gridSize; col++) {
             Cell* cell1 = getCell(row, col);
             Cell* cell2 = getCell(row + 1, col);
-            Edge* edge = new Edge(cell1, cell2);
+            edgeStorage.emplace_back(cell1, cell2, edges.size());
+            Edge* edge = &edgeStorage.back();
             edges.push_back(edge);
             cell1->addEdge(edge);
             cell2->addEdge(edge);
         }
     }
+    nogoods.reset(edges.size());
+    
+    // Fixed seed, so a state hashes the same in every run
+    std::mt19937_64 keyRng(0x9e3779b97f4a7c15ULL);
+    for (Edge* edge : edges) {
+        for (uint64_t& key : edge->zobristKeys) {
+            key = keyRng();
+        }
+    }
     
-    std::cout << "Initialized " << cells.size() << " cells and " 
-              << edges.size() << " edges" << std::endl;
+    if (!workerCopy) {
+        *console << "Initialized " << cells.size() << " cells and " 
+                  << edges.size() << " edges" << std::endl;
+    }
 }
 
 int TurnPuzzle::getSize() const {
@@ -188,85 +327,80 @@ bool TurnPuzzle::canAddEdge(const Edge& edge) {
     if (edge.cell1->getDegree() >= 2) return false;
     if (edge.cell2->getDegree() >= 2) return false;
     
-    // Find the path connected to each endpoint
-    Path path1;
-    Path path2;
-    
-    resetVisitedFlags();
-    
-    findPath(edge.cell1, path1);
-    findPath(edge.cell2, path2);
-    
-    // If either path has zero cells, return false
-    if (path1.getLength() == 0 || path2.getLength() == 0) {
+    // Both cells are now path endpoints, so the registry describes their paths
+    // If they are the two ends of the same path the edge would create a closed loop
+    if (pathRegistry.formsLoop(edge.cell1, edge.cell2)) {
         return false;
     }
     
-    // Check if both cells are part of the same path (would create a closed loop)
-    // This happens when both endpoints have degree 1 and the paths share cells
-    if (edge.cell1->getDegree() == 1 && edge.cell2->getDegree() == 1) {
-        // Check if cell2 appears in path1 (meaning they're the same path)
-        for (Cell* cell : path1.cells) {
-            if (cell == edge.cell2) {
-                // Both endpoints are part of the same path - would create a loop
-                return false;
-            }
-        }
-    }
-    
-    // Combine the paths: path1 in reverse, then path2
-    Path combinedPath;
-    
-    // Add path1 in reverse order
-    for (int i = path1.getLength() - 1; i >= 0; i--) {
-        combinedPath.addCell(path1.cells[i]);
-    }
-    
-    // Add path2 in normal order
-    for (int i = 0; i < path2.getLength(); i++) {
-        combinedPath.addCell(path2.cells[i]);
+    // Return true only if the combined path doesn't have mixed turns
+    return !pathRegistry.wouldMixTurns(edge.cell1, edge.cell2);
+}
+
+void TurnPuzzle::refreshCandidate(Edge* edge) {
+    bool addable = canAddEdge(*edge);
+    int position = candidatePosition[edge->id];
+    
+    if (addable && position == -1) {
+        candidatePosition[edge->id] = addableEdges.size();
+        addableEdges.push_back(edge);
+    } else if (!addable && position != -1) {
+        // Swap-remove: move the last candidate into the freed slot
+        Edge* last = addableEdges.back();
+        addableEdges[position] = last;
+        candidatePosition[last->id] = position;
+        addableEdges.pop_back();
+        candidatePosition[edge->id] = -1;
     }
-    
-    // Calculate the turn type of the combined path
-    combinedPath.calculateTurnType();
-    
-    // Return true only if the path doesn't have mixed turns
-    return combinedPath.turnType != RIGHT_LEFT_MIXED;
 }
 
 void TurnPuzzle::generateSolution() {
-    std::cout << "Generating solution..." << std::endl;
+    *console << "Generating solution..." << std::endl;
     
-    // Use fixed seed for reproducibility
-    std::mt19937 gen(42);
-    std::vector<Edge*> addableEdges;
+    // Use a fixed seed for reproducibility
+    std::mt19937 gen(seed);
     
-    do {
-        // Clear the list and find all edges that can be added using canAddEdge
-        addableEdges.clear();
-        for (Edge* edge : edges) {
-            if (canAddEdge(*edge)) {
-                addableEdges.push_back(edge);
-            }
-        }
+    // Every cell starts out as its own single-cell path
+    pathRegistry.reset(gridSize);
+    
+    // Test every edge once; afterwards only edges near a change are re-tested
+    addableEdges.clear();
+    candidatePosition.assign(edges.size(), -1);
+    for (Edge* edge : edges) {
+        refreshCandidate(edge);
+    }
+    
+    while (!addableEdges.empty()) {
+        // Pick a candidate randomly
+        std::uniform_int_distribution<> dis(0, addableEdges.size() - 1);
+        Edge* selectedEdge = addableEdges[dis(gen)];
         
-        // If edges can be added, pick one randomly
-        if (!addableEdges.empty()) {
-            std::uniform_int_distribution<> dis(0, addableEdges.size() - 1);
-            Edge* selectedEdge = addableEdges[dis(gen)];
-            
-            // Set the edge state to INCLUDED (this will update cell degrees automatically)
-            selectedEdge->setState(INCLUDED);
-        }
+        // The far ends of both paths become the endpoints of the joined path
+        Cell* affectedCells[4] = {
+            selectedEdge->cell1,
+            selectedEdge->cell2,
+            cells[pathRegistry.getEnd(selectedEdge->cell1).partner],
+            cells[pathRegistry.getEnd(selectedEdge->cell2).partner]
+        };
+        
+        // Set the edge state to INCLUDED (this will update cell degrees automatically)
+        selectedEdge->setState(INCLUDED);
+        pathRegistry.join(selectedEdge->cell1, selectedEdge->cell2);
         
-    } while (!addableEdges.empty());
+        // Only edges touching the joined cells or the new path endpoints can change status
+        for (Cell* cell : affectedCells) {
+            for (Edge* edge : cell->edges) {
+                refreshCandidate(edge);
+            }
+        }
+    }
 }
 
 void TurnPuzzle::markCells() {
-    std::cout << "Marking cells as HEAD..." << std::endl;
+    *console << "Marking cells as HEAD..." << std::endl;
     
     std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seeded ? seed + 1 : rd());
     
     resetVisitedFlags();
     
@@ -283,7 +417,7 @@ void TurnPuzzle::markCells() {
     
     // Process each unvisited endpoint
     for (Cell* startCell : endpoints) {
-        if (!startCell->visited && startCell->getDegree() == 1) {
+        if (!isVisited(startCell) && startCell->getDegree() == 1) {
             Path path;
             findPath(startCell, path);
             
@@ -296,35 +430,35 @@ void TurnPuzzle::markCells() {
         }
     }
     
-    std::cout << "Cells marked!" << std::endl;
+    *console << "Cells marked!" << std::endl;
     
     // Save the original solution edge states
     SaveEdgeStates(originalSolution);
 }
 
 void TurnPuzzle::printSolution() const {
-    std::cout << "\nGrid with included edges:" << std::endl;
+    *console << "\nGrid with included edges:" << std::endl;
     
     // Print cell degrees
     for (int i = 0; i < gridSize; i++) {
         for (int j = 0; j < gridSize; j++) {
             Cell* cell = getCell(i, j);
-            std::cout << "(" << i << "," << j << "):deg=" << cell->getDegree() << " ";
+            *console << "(" << i << "," << j << "):deg=" << cell->getDegree() << " ";
         }
-        std::cout << std::endl;
+        *console << std::endl;
     }
     
     // Print included edges
-    std::cout << "\nIncluded edges:" << std::endl;
+    *console << "\nIncluded edges:" << std::endl;
     int edgeCount = 0;
     for (const Edge* edge : edges) {
         if (edge->isIncluded()) {
             edgeCount++;
-            std::cout << "Edge " << edgeCount << ": (" << edge->cell1->row << "," << edge->cell1->col 
+            *console << "Edge " << edgeCount << ": (" << edge->cell1->row << "," << edge->cell1->col 
                      << ") <-> (" << edge->cell2->row << "," << edge->cell2->col << ")" << std::endl;
         }
     }
-    std::cout << "Total included edges: " << edgeCount << std::endl;
+    *console << "Total included edges: " << edgeCount << std::endl;
 }
 
 void TurnPuzzle::exportToSVG(const std::string& filename) const {
@@ -433,11 +567,11 @@ void TurnPuzzle::exportToSVG(const std::string& filename) const {
     file << "</svg>\n";
     file.close();
     
-    std::cout << "SVG exported to: " << filename << std::endl;
+    *console << "SVG exported to: " << filename << std::endl;
 }
 
 bool TurnPuzzle::GeneratePuzzle() {
-    std::cout << "Generating puzzle..." << std::endl;
+    *console << "Generating puzzle..." << std::endl;
     
     // Generate the solution
     generateSolution();
@@ -446,18 +580,19 @@ bool TurnPuzzle::GeneratePuzzle() {
     markCells();
     
     // Export the original solution
-    exportToSVG("solution.svg");
+    exportToSVG(outputPrefix + "solution.svg");
     
-    std::cout << "Testing for different solution..." << std::endl;
+    *console << "Testing for different solution..." << std::endl;
     
     // Try to find different solutions
     solvePuzzle();
+    exportProblem();
     
     return true;
 }
 
 void TurnPuzzle::solvePuzzle() {
-    std::cout << "Solving puzzle..." << std::endl;
+    *console << "Solving puzzle..." << std::endl;
     
     // Clear all edge states to start fresh
     for (Edge* edge : edges) {
@@ -465,6 +600,13 @@ void TurnPuzzle::solvePuzzle() {
     }
     
     int solutionCount = 0;
+    searchNodes = 0;
+    probeCount = 0;
+    
+    // Nogoods and proven states stay valid while walls are added, but not for other HEAD cells or
+    // another solution
+    nogoods.reset(edges.size());
+    transpositions.clear();
     
     while (true) {
         // At the beginning of each loop, mark every edge as UNDECIDED except DELETED edges
@@ -475,25 +617,48 @@ void TurnPuzzle::solvePuzzle() {
             // If edge is DELETED, leave it alone
         }
         
-        int diffIndex = FindDifferentSolution(solutionCount);
+        // An exact count of 1 settles uniqueness without an exhaustive search
+        int diffIndex;
+        if (solutionCounting && countSolutions() <= 1) {
+            diffIndex = -1;
+            searchWalls.clear();
+        } else {
+            diffIndex = runSearch(solutionCount);
+        }
+        
+        // An incremental search adds its walls itself and only returns once no different solution is left
+        solutionCount += searchWalls.size();
         
         if (diffIndex == -1) {
             // No more different solutions found
-            std::cout << "Total different solutions found: " << solutionCount << std::endl;
+            *console << "Total different solutions found: " << solutionCount << std::endl;
+            *console << "Total search nodes: " << searchNodes << std::endl;
+            if (probeBudget > 0) {
+                *console << "Total probes: " << probeCount << std::endl;
+            }
+            if (transpositions.isEnabled()) {
+                long long probes = transpositions.getProbes();
+                long long hits = transpositions.getHits();
+                double hitRate = probes > 0 ? 100.0 * hits / probes : 0.0;
+                *console << "Transposition table: " << probes << " probes, " << hits << " hits ("
+                          << hitRate << "%), " << (probes - hits) << " misses (" << (100.0 - hitRate) << "%), "
+                          << transpositions.getStores() << " stores, " << transpositions.getReplacements()
+                          << " replaced, " << transpositions.getCapacity() << " entries" << std::endl;
+            }
             break;  // Exit the loop
         }
         
         solutionCount++;
-        std::cout << "Solution #" << solutionCount << " differs at edge index: " << diffIndex << std::endl;
+        *console << "Solution #" << solutionCount << " differs at edge index: " << diffIndex << std::endl;
         
         // Mark this edge as DELETED for future searches
         edges[diffIndex]->setState(DELETED);
         
-        std::cout << "Marked edge " << diffIndex << " as DELETED, searching for next solution..." << std::endl;
+        *console << "Marked edge " << diffIndex << " as DELETED, searching for next solution..." << std::endl;
     }
     
     // Clean up: clear all edge states except keep DELETED edges status
-    std::cout << "Cleaning up edge states..." << std::endl;
+    *console << "Cleaning up edge states..." << std::endl;
     for (Edge* edge : edges) {
         if (!edge->isDeleted()) {
             // Clear non-deleted edges to UNDECIDED
@@ -501,10 +666,79 @@ void TurnPuzzle::solvePuzzle() {
         }
         // If edge is DELETED, keep it as DELETED
     }
+}
+
+int TurnPuzzle::runSearch(int solutionNumber) {
+    if (searchThreads > 1) {
+        return searchDifferentSolutionParallel(solutionNumber);
+    }
+    if (solverEngine == TurnPuzzleTypes::SolverEngine::BITBOARD) {
+        return searchDifferentSolutionBitboard(solutionNumber);
+    }
+    return searchDifferentSolution(solutionNumber);
+}
+
+void TurnPuzzle::loadPuzzle(const std::vector<int>& headCells, const std::vector<int>& wallEdges) {
+    for (Cell* cell : cells) {
+        cell->cellType = UNMARKED;
+    }
+    for (int id : headCells) {
+        cells[id]->cellType = HEAD;
+    }
+    for (Edge* edge : edges) {
+        edge->setState(UNDECIDED);
+    }
+    for (int id : wallEdges) {
+        edges[id]->setState(DELETED);
+    }
+    originalSolution.assign(edges.size(), UNDECIDED);
+}
+
+int TurnPuzzle::checkUniqueness(std::vector<EdgeState>& solution) {
+    searchNodes = 0;
+    probeCount = 0;
+    
+    // Everything learned while looking for the first solution rules out every solution, so it
+    // stays valid for the second search
+    nogoods.reset(edges.size());
+    transpositions.clear();
+    
+    // Walls found here are reported, not added, and solutions are not exported
+    const bool incremental = incrementalSearch;
+    incrementalSearch = false;
+    solutionExport = false;
+    
+    // With no original solution, any solution counts as different
+    originalSolution.assign(edges.size(), UNDECIDED);
+    int found = 0;
+    if (runSearch(0) != -1) {
+        found = 1;
+        SaveEdgeStates(originalSolution);
+        for (Edge* edge : edges) {
+            if (!edge->isDeleted()) {
+                edge->setState(UNDECIDED);
+            }
+        }
+        if (runSearch(1) != -1) {
+            found = 2;
+        }
+    }
+    solution = originalSolution;
     
+    for (Edge* edge : edges) {
+        if (!edge->isDeleted()) {
+            edge->setState(UNDECIDED);
+        }
+    }
+    incrementalSearch = incremental;
+    solutionExport = true;
+    return found;
+}
+
+void TurnPuzzle::exportProblem() const {
     // Export the puzzle with DELETED edges visible as separators
-    exportToSVG("problem.svg");
-    std::cout << "Puzzle exported to problem.svg" << std::endl;
+    exportToSVG(outputPrefix + "problem.svg");
+    *console << "Puzzle exported to " << outputPrefix << "problem.svg" << std::endl;
 }
 
 
@@ -515,9 +749,21 @@ void TurnPuzzle::SaveEdgeStates(std::vector<EdgeState>& edgeStates) {
     }
 }
 
-void TurnPuzzle::RestoreEdgeStates(const std::vector<EdgeState>& edgeStates) {
-    for (size_t i = 0; i < edges.size() && i < edgeStates.size(); ++i) {
-        edges[i]->setState(edgeStates[i]);
+void TurnPuzzle::setEdgeTrail(Trail* edgeTrail) {
+    for (Edge* edge : edges) {
+        edge->trail = edgeTrail;
+    }
+}
+
+void TurnPuzzle::setEdgeHash(uint64_t* hash) {
+    if (hash != nullptr) {
+        *hash = 0;
+        for (Edge* edge : edges) {
+            *hash ^= edge->zobristKey();
+        }
+    }
+    for (Edge* edge : edges) {
+        edge->stateHash = hash;
     }
 }
 
@@ -544,66 +790,76 @@ int TurnPuzzle::FindDifferentSolution(int solutionNumber) {
         logFile << "=== Entering FindDifferentSolution ===" << std::endl;
     }
     
-    TurnPuzzleTypes::SolveOutput result;
+    // Stop as soon as another worker has found a different solution
+    if (parallelSearch != nullptr && parallelSearch->isCancelled()) {
+        searchAborted = true;
+        return -1;
+    }
     
-    while (true) {
-        result = SolveCells();
-        
-        if (result == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED) {
-            break;
-        }
-        
-        std::vector<Path> paths;
-        if (!findPaths(paths)) {
-            result = TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
-            break;
-        }
-        
-        if (result == TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE) {
-            break;
-        }
-        
-        // If SOLVE_UPDATED, continue the loop
+    // Give up on this attempt once a restart node limit is reached
+    searchNodes++;
+    const long long nodesBefore = searchNodes;
+    if (nodeLimit > 0 && searchNodes - attemptStartNodes > nodeLimit) {
+        searchAborted = true;
+        return -1;
+    }
+    
+    // Nogoods of a single literal hold from the root on
+    if (decisionPath.empty() && !applyUnitNogoods()) {
+        return -1;
     }
     
+    // Re-check only the cells touched by edge changes since the last propagation
+    TurnPuzzleTypes::SolveOutput result = propagate();
+    
     if (result == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED)
     {
         return -1;
     }
+    
+    // Another branch order may already have proven this state
+    if (transpositions.isEnabled() && transpositions.contains(stateHash)) {
+        conflictReason = levelsUpTo(decisionPath.size());
+        return -1;
+    }
+    
+    // Values that fail at once are ruled out before branching
+    if (probeBudget > 0 && !probeEdges()) {
+        return -1;
+    }
 
     // Check if puzzle is solved
     if (isSolved()) {        
         // Check if it's different from the original solution
-        std::vector<EdgeState> currentStates;
-        SaveEdgeStates(currentStates);
+        SaveEdgeStates(solvedStates);
         
-        int diffIndex = FindDifferentEdge(currentStates, originalSolution);
+        int diffIndex = FindDifferentEdge(solvedStates, originalSolution);
+        if (diffIndex != -1 && incrementalSearch) {
+            addPendingWall(diffIndex, solutionNumber);
+            return -1;
+        }
         if (diffIndex != -1) {
-            std::cout << "Found different solution!" << std::endl;
-            
-            // Create unique filename for this solution
-            std::string filename = "differentSolution" + std::to_string(solutionNumber + 1) + ".svg";
-            exportToSVG(filename);
+            // Worker copies leave reporting to the puzzle that started the search
+            if (!workerCopy) {
+                reportDifferentSolution(solutionNumber);
+            }
             return diffIndex;
         }
         
-        std::cout << "Found solution but it matches the original" << std::endl;
-    }
-    
-    // Find an undecided edge
-    Edge* undecidedEdge = nullptr;
-    for (Edge* edge : edges) {
-        if (edge->isUndecided()) {
-            undecidedEdge = edge;
-            break;
+        if (!workerCopy) {
+            *console << "Found solution but it matches the original" << std::endl;
         }
     }
     
+    // Pick the edge to branch on
+    Edge* undecidedEdge = selectBranchEdge();
+    
     // If no undecided edge found, we're done (no different solution)
     if (undecidedEdge == nullptr) {
         if (logFile.is_open()) {
             logFile << "No undecided edges found, returning -1" << std::endl;
         }
+        conflictReason = levelsUpTo(decisionPath.size());
         return -1;
     }
     
@@ -612,36 +868,108 @@ int TurnPuzzle::FindDifferentSolution(int solutionNumber) {
                   << ") <-> (" << undecidedEdge->cell2->row << "," << undecidedEdge->cell2->col << ")" << std::endl;
     }
     
-    // Save current edge states
-    std::vector<EdgeState> savedStates;
-    SaveEdgeStates(savedStates);
+    // Remember the trail position so backtracking only reverts what changed below this node
+    size_t trailMark = trail.size();
+    
+    // In a parallel search, offer the EXCLUDED branch to idle workers
+    bool offered = false;
+    if (parallelSearch != nullptr && parallelSearch->wantsTask(workerIndex)) {
+        decisionPath.push_back({undecidedEdge->id, EXCLUDED});
+        parallelSearch->pushTask(workerIndex, decisionPath);
+        decisionPath.pop_back();
+        offered = true;
+    }
     
     // Try marking the edge as INCLUDED
     if (logFile.is_open()) {
         logFile << "Trying edge as INCLUDED..." << std::endl;
     }
+    decisionPath.push_back({undecidedEdge->id, INCLUDED});
+    const size_t level = decisionPath.size();
     undecidedEdge->setState(INCLUDED);
+    stampReasons(levelBit(level));
     int result1 = FindDifferentSolution(solutionNumber);
-    if (result1 != -1) {
+    decisionPath.pop_back();
+    if (pendingWall != nullptr) {
+        if (!applyPendingWall(trailMark)) {
+            return -1;
+        }
+        // Everything below the INCLUDED decision relied on the wall edge, so search this node again
+        return FindDifferentSolution(solutionNumber);
+    }
+    if (result1 != -1 || searchAborted) {
         return result1;
     }
+    uint64_t includedReason = conflictReason;
+    
+    // The INCLUDED branch failed on earlier decisions alone, so the EXCLUDED branch fails the same
+    // way; jump back to the newest decision the failure depends on
+    if ((includedReason & levelBit(level)) == 0) {
+        if (offered) {
+            parallelSearch->reclaimTask(workerIndex);
+        }
+        backtrack(trailMark);
+        if (transpositions.isEnabled()) {
+            transpositions.store(stateHash, searchNodes - nodesBefore);
+        }
+        return -1;
+    }
+    
+    // Another worker is searching the EXCLUDED branch
+    if (offered && !parallelSearch->reclaimTask(workerIndex)) {
+        backtrack(trailMark);
+        conflictReason = ~uint64_t(0);
+        return -1;
+    }
+    
+    // Past level 64 the bit is shared with deeper levels and has to stay
+    const uint64_t ownBit = level < 64 ? levelBit(level) : 0;
     
     // Restore edge states and try EXCLUDED
     if (logFile.is_open()) {
         logFile << "Backtracking... trying edge as EXCLUDED..." << std::endl;
     }
-    RestoreEdgeStates(savedStates);
-    undecidedEdge->setState(EXCLUDED);
-    int result2 = FindDifferentSolution(solutionNumber);
-    if (result2 != -1) {
+    backtrack(trailMark);
+    int result2;
+    while (true) {
+        // EXCLUDED is implied by the decisions the INCLUDED branch failed on
+        decisionPath.push_back({undecidedEdge->id, EXCLUDED});
+        undecidedEdge->setState(EXCLUDED);
+        stampReasons(includedReason & ~ownBit);
+        result2 = FindDifferentSolution(solutionNumber);
+        decisionPath.pop_back();
+        
+        // The INCLUDED branch has no different solution without the wall, so it has none with it
+        // either; only the EXCLUDED branch is searched again
+        if (pendingWall == nullptr) {
+            break;
+        }
+        if (!applyPendingWall(trailMark)) {
+            return -1;
+        }
+    }
+    if (result2 != -1 || searchAborted) {
         return result2;
     }
     
+    // Neither value of the edge works for the decisions both branches failed on
+    uint64_t reason = conflictReason;
+    if (reason & levelBit(level)) {
+        reason = (reason | includedReason) & ~ownBit;
+    }
+    if (!workerCopy) {
+        learnNogood(reason);
+    }
+    
     // Restore edge states before returning
     if (logFile.is_open()) {
         logFile << "Both options failed for this edge, backtracking further..." << std::endl;
     }
-    RestoreEdgeStates(savedStates);
+    backtrack(trailMark);
+    conflictReason = reason;
+    if (transpositions.isEnabled()) {
+        transpositions.store(stateHash, searchNodes - nodesBefore);
+    }
     
     return -1;
 }
@@ -670,27 +998,19 @@ bool TurnPuzzle::isSolved() {
             }
         }*/
     
-    // Verify paths are valid and cover the whole grid
-    std::vector<Path> paths;
-    if (!findPaths(paths)) {
-        return false;
-    }
-    
-    // Count total cells in all paths
-    int totalPathCells = 0;
-    for (const Path& path : paths) {
-        totalPathCells += path.getLength();
-    }
-    
-    // Check if paths cover the whole grid
-    if (totalPathCells != static_cast<int>(cells.size())) {
+    // Verify paths are valid and cover the whole grid, without storing them
+    PathValidation validation = validatePaths();
+    if (!validation.isValid() || validation.coveredCells != static_cast<int>(cells.size())) {
         return false;
     }
     
-    std::cout << "TurnPuzzle::isSolved()" << std::endl;
-    for (const Path& path : paths)
-    {
-        std::cout << "Path Length : " << path.getLength() << std::endl;
+    if (!workerCopy) {
+        *console << "TurnPuzzle::isSolved()" << std::endl;
+        tracePaths(reportedPaths);
+        for (int i = 0; i < reportedPaths.getPathCount(); i++)
+        {
+            *console << "Path Length : " << reportedPaths.getPathLength(i) << std::endl;
+        }
     }
     return true;
 }
@@ -698,7 +1018,7 @@ bool TurnPuzzle::isSolved() {
 bool TurnPuzzle::tryConnectHeadToTail(Cell* head, Cell* tail, std::vector<Cell*>& unpairedHeads, std::vector<Cell*>& unpairedTails) {
     // Base case: all heads are paired
     if (unpairedHeads.empty()) {
-        std::cout << "Successfully paired all HEADs and TAILs!" << std::endl;
+        *console << "Successfully paired all HEADs and TAILs!" << std::endl;
         return true;
     }
     
@@ -709,7 +1029,7 @@ bool TurnPuzzle::tryConnectHeadToTail(Cell* head, Cell* tail, std::vector<Cell*>
     for (size_t i = 0; i < unpairedTails.size(); i++) {
         Cell* currentTail = unpairedTails[i];
         
-        std::cout << "Trying to connect HEAD at (" << currentHead->row << "," << currentHead->col 
+        *console << "Trying to connect HEAD at (" << currentHead->row << "," << currentHead->col 
                   << ") to TAIL at (" << currentTail->row << "," << currentTail->col << ")" << std::endl;
         
         // Try to find a valid path between them
@@ -717,7 +1037,7 @@ bool TurnPuzzle::tryConnectHeadToTail(Cell* head, Cell* tail, std::vector<Cell*>
         if (findPathBetween(currentHead, currentTail, testPath)) {
             testPath.calculateTurnType();
             
-            std::cout << "Found path with " << testPath.getLength() << " cells, turn type: " << testPath.turnType << std::endl;
+            *console << "Found path with " << testPath.getLength() << " cells, turn type: " << testPath.turnType << std::endl;
             
             // Check if the path has valid turn type (not mixed)
             if (testPath.turnType != RIGHT_LEFT_MIXED) {
@@ -727,15 +1047,9 @@ bool TurnPuzzle::tryConnectHeadToTail(Cell* head, Cell* tail, std::vector<Cell*>
                     Cell* from = testPath.cells[j];
                     Cell* to = testPath.cells[j + 1];
                     
-                    // Find the edge between these cells
-                    for (Edge* edge : edges) {
-                        if ((edge->cell1 == from && edge->cell2 == to) ||
-                            (edge->cell1 == to && edge->cell2 == from)) {
-                            pathEdges.push_back(edge);
-                            edge->setState(INCLUDED);
-                            break;
-                        }
-                    }
+                    Edge* edge = edgeBetween(from, to);
+                    pathEdges.push_back(edge);
+                    edge->setState(INCLUDED);
                 }
                 
                 // Remove this head and tail from unpaired lists
@@ -758,7 +1072,7 @@ bool TurnPuzzle::tryConnectHeadToTail(Cell* head, Cell* tail, std::vector<Cell*>
     }
     
     // Failed to find a valid pairing
-    std::cout << "Failed to connect HEAD at (" << currentHead->row << "," << currentHead->col << ")" << std::endl;
+    *console << "Failed to connect HEAD at (" << currentHead->row << "," << currentHead->col << ")" << std::endl;
     return false;
 }
 
@@ -768,7 +1082,7 @@ bool TurnPuzzle::findPathBetween(Cell* start, Cell* end, Path& path) {
     
     std::queue<std::vector<Cell*>> queue;
     queue.push({start});
-    start->visited = true;
+    markVisited(start);
     
     while (!queue.empty()) {
         std::vector<Cell*> currentPath = queue.front();
@@ -799,7 +1113,7 @@ bool TurnPuzzle::findPathBetween(Cell* start, Cell* end, Path& path) {
             Cell* neighbor = (edge->cell1 == current) ? edge->cell2 : edge->cell1;
             
             // Skip if already visited or degree would exceed 2
-            if (neighbor->visited || neighbor->getDegree() >= 2) {
+            if (isVisited(neighbor) || neighbor->getDegree() >= 2) {
                 continue;
             }
             
@@ -810,7 +1124,7 @@ bool TurnPuzzle::findPathBetween(Cell* start, Cell* end, Path& path) {
             std::vector<Cell*> newPath = currentPath;
             newPath.push_back(neighbor);
             
-            neighbor->visited = true;
+            markVisited(neighbor);
             queue.push(newPath);
         }
     }
@@ -818,26 +1132,882 @@ bool TurnPuzzle::findPathBetween(Cell* start, Cell* end, Path& path) {
     return false; // No path found
 }
 
-TurnPuzzleTypes::SolveOutput TurnPuzzle::SolveCells() {
+void TurnPuzzle::backtrack(size_t trailMark) {
+    undoneEdges.clear();
+    for (size_t i = trailMark; i < trail.size(); i++) {
+        undoneEdges.push_back(trail.getEntry(i).edge);
+    }
+    trail.undoTo(trailMark);
+    pathUnion.undoTo(trailMark);
+    for (Edge* edge : undoneEdges) {
+        updateTailState(edge->cell1);
+        updateTailState(edge->cell2);
+    }
+    
+    // Undone changes no longer need to be propagated
+    if (propagationCursor > trailMark) {
+        propagationCursor = trailMark;
+    }
+    if (reasonCursor > trailMark) {
+        reasonCursor = trailMark;
+    }
+    
+    // Search walls are not on the trail, but what they implied was, so check their cells again
+    if (trailMark <= wallMark && !searchWalls.empty()) {
+        for (Edge* wall : searchWalls) {
+            enqueueCell(wall->cell1);
+            enqueueCell(wall->cell2);
+        }
+        wallMark = trailMark;
+    }
+}
+
+void TurnPuzzle::enqueueCell(Cell* cell) {
+    int index = cellIndex(cell);
+    if (!cellQueued[index]) {
+        cellQueued[index] = true;
+        cellQueue.push(cell);
+    }
+}
+
+TurnPuzzleTypes::SolveOutput TurnPuzzle::propagate() {
     bool anyUpdated = false;
     
-    // Iterate through all cells in the grid
-    for (Cell* cell : cells) {
-        TurnPuzzleTypes::SolveOutput result = cell->Solve();
+    while (true) {
+        // Every rule gives the edges it changes a reason; anything else depends on the whole grid
+        if (reasonCursor < trail.size()) {
+            stampReasons(levelsUpTo(decisionPath.size()));
+        }
         
-        // If any cell fails, return SOLVE_FAILED immediately
-        if (result == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED) {
-            return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+        // Turn edge changes recorded on the trail into work for their two cells
+        while (propagationCursor < trail.size()) {
+            size_t position = propagationCursor++;
+            Edge* edge = trail.getEntry(position).edge;
+            enqueueCell(edge->cell1);
+            enqueueCell(edge->cell2);
+            updateTailState(edge->cell1);
+            updateTailState(edge->cell2);
+            
+            // Only a newly INCLUDED edge changes the shape of a path
+            if (edge->isIncluded()) {
+                pathQueue.push_back(edge->cell1);
+                if (!joinPaths(edge, position)) {
+                    clearPropagationQueues();
+                    return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+                }
+            } else {
+                // Only a lost edge can cut cells off from the HEAD paths
+                regionQueue.push_back(edge->cell1);
+                regionQueue.push_back(edge->cell2);
+            }
+            
+            if (!propagateNogoods(edge)) {
+                clearPropagationQueues();
+                return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+            }
+        }
+        
+        if (cellQueue.empty()) {
+            // With every cell settled, check the global tail count; forced edges add more work
+            TurnPuzzleTypes::SolveOutput budget = checkTailBudget();
+            if (budget == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED) {
+                clearPropagationQueues();
+                return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+            }
+            if (budget == TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE) {
+                break;
+            }
+            anyUpdated = true;
+            continue;
+        }
+        
+        Cell* cell = cellQueue.front();
+        cellQueue.pop();
+        cellQueued[cellIndex(cell)] = false;
+        
+        size_t trailBefore = trail.size();
+        TurnPuzzleTypes::SolveOutput result = cell->Solve();
+        if (result != TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE) {
+            // The edges Solve() just changed hold stale reasons, and their new one can not depend on them
+            for (size_t i = trailBefore; i < trail.size(); i++) {
+                edgeReason[trail.getEntry(i).edge->id] = 0;
+            }
+            uint64_t reason = solveReason(cell);
+            if (result == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED) {
+                conflictReason = reason;
+                clearPropagationQueues();
+                return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+            }
+            stampReasons(reason);
         }
         
-        // Track if any cell was updated
         if (result == TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED) {
             anyUpdated = true;
         }
     }
     
-    // If any cell was updated, return SOLVE_UPDATED
-    // Otherwise return SOLVE_NO_CHANGE
-    return anyUpdated ? TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED 
-                      : TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+    // Cell degrees are consistent now, so the paths that grew can be validated
+    for (Cell* cell : pathQueue) {
+        if (!checkPathThrough(cell)) {
+            conflictReason = pathUnion.getReason(cell->id);
+            clearPropagationQueues();
+            return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+        }
+    }
+    pathQueue.clear();
+    
+    if (!checkRegions()) {
+        clearPropagationQueues();
+        return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+    }
+    
+    return anyUpdated ? TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED 
+                      : TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+}
+
+void TurnPuzzle::resetSearchIndexes() {
+    pathUnion.reset(cells.size());
+    edgeReason.assign(edges.size(), 0);
+    reasonCursor = 0;
+    
+    tailState.assign(cells.size(), 0);
+    certainTails = 0;
+    possibleTails = 0;
+    headCount = 0;
+    for (Cell* cell : cells) {
+        if (cell->cellType == HEAD) {
+            headCount++;
+        }
+        updateTailState(cell);
+    }
+}
+
+void TurnPuzzle::updateTailState(Cell* cell) {
+    char state = 0;
+    if (cell->cellType == UNMARKED && cell->getDegree() <= 1) {
+        state = (cell->getDegree() == 1 && !cell->hasUndecidedEdge()) ? 2 : 1;
+    }
+    
+    char& oldState = tailState[cell->id];
+    certainTails += (state == 2) - (oldState == 2);
+    possibleTails += (state >= 1) - (oldState >= 1);
+    oldState = state;
+}
+
+TurnPuzzleTypes::SolveOutput TurnPuzzle::checkTailBudget() {
+    // Cell::Solve gives every HEAD degree 1, so a solution has exactly one tail per HEAD
+    if (certainTails > headCount) {
+        conflictReason = tailReason(2);
+        return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+    }
+    if (possibleTails < headCount) {
+        conflictReason = tailReason(0);
+        return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+    }
+    if (certainTails < headCount) {
+        return TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+    }
+    
+    // Every tail is known, so the other UNMARKED cells need degree 2
+    uint64_t tailsReason = tailReason(2);
+    bool updated = false;
+    for (Cell* cell : cells) {
+        if (tailState[cell->id] != 1) {
+            continue;
+        }
+        
+        int needed = 2 - cell->getDegree();
+        int undecidedCount = 0;
+        for (Edge* edge : cell->edges) {
+            if (edge->isUndecided()) {
+                undecidedCount++;
+            }
+        }
+        if (undecidedCount < needed) {
+            conflictReason = tailsReason | cellEdgesReason(cell);
+            return TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+        }
+        if (undecidedCount == needed) {
+            uint64_t reason = tailsReason | cellEdgesReason(cell);
+            for (Edge* edge : cell->edges) {
+                if (edge->isUndecided()) {
+                    edge->setState(INCLUDED);
+                }
+            }
+            stampReasons(reason);
+            updated = true;
+        }
+    }
+    
+    return updated ? TurnPuzzleTypes::SolveOutput::SOLVE_UPDATED
+                   : TurnPuzzleTypes::SolveOutput::SOLVE_NO_CHANGE;
+}
+
+bool TurnPuzzle::joinPaths(Edge* edge, size_t trailPosition) {
+    uint64_t reason = edgeReason[edge->id];
+    if (!pathUnion.join(edge->cell1->id, edge->cell2->id, trailPosition, reason)) {
+        conflictReason = reason | pathUnion.getReason(edge->cell1->id);
+        return false;
+    }
+    
+    // Any other edge inside the new path touches a full cell, so the only edge that could
+    // close it into a loop is one joining its two ends
+    Cell* end1 = cells[pathUnion.getEnd1(edge->cell1->id)];
+    Cell* end2 = cells[pathUnion.getEnd2(edge->cell1->id)];
+    if (std::abs(end1->row - end2->row) + std::abs(end1->col - end2->col) == 1) {
+        Edge* closingEdge = edgeBetween(end1, end2);
+        if (closingEdge->isUndecided()) {
+            closingEdge->setState(EXCLUDED);
+            stampReasons(pathUnion.getReason(edge->cell1->id));
+        }
+    }
+    return true;
+}
+
+uint64_t TurnPuzzle::levelBit(size_t level) const {
+    return uint64_t(1) << (level < 64 ? level - 1 : 63);
+}
+
+uint64_t TurnPuzzle::levelsUpTo(size_t level) const {
+    return level >= 64 ? ~uint64_t(0) : (uint64_t(1) << level) - 1;
+}
+
+void TurnPuzzle::stampReasons(uint64_t reason) {
+    for (; reasonCursor < trail.size(); reasonCursor++) {
+        edgeReason[trail.getEntry(reasonCursor).edge->id] = reason;
+    }
+}
+
+uint64_t TurnPuzzle::cellEdgesReason(const Cell* cell) const {
+    uint64_t reason = 0;
+    for (Edge* edge : cell->edges) {
+        if (!edge->isUndecided()) {
+            reason |= edgeReason[edge->id];
+        }
+    }
+    return reason;
+}
+
+uint64_t TurnPuzzle::solveReason(const Cell* cell) const {
+    // The cell's degree and path, and whether the far end of the path can still grow
+    uint64_t reason = cellEdgesReason(cell) | pathUnion.getReason(cell->id);
+    reason |= cellEdgesReason(cells[pathUnion.getEnd1(cell->id)]);
+    reason |= cellEdgesReason(cells[pathUnion.getEnd2(cell->id)]);
+    
+    // The turn rule also looks at the degree and path of every neighbor
+    for (Edge* edge : cell->edges) {
+        Cell* neighbor = (edge->cell1 == cell) ? edge->cell2 : edge->cell1;
+        reason |= cellEdgesReason(neighbor) | pathUnion.getReason(neighbor->id);
+    }
+    return reason;
+}
+
+uint64_t TurnPuzzle::tailReason(char state) const {
+    uint64_t reason = 0;
+    for (Cell* cell : cells) {
+        if (cell->cellType == UNMARKED && tailState[cell->id] == state) {
+            reason |= cellEdgesReason(cell);
+        }
+    }
+    return reason;
+}
+
+bool TurnPuzzle::propagateNogoods(Edge* edge) {
+    if (nogoods.size() == 0) {
+        return true;
+    }
+    
+    unitNogoods.clear();
+    int conflict = nogoods.update({edge->id, edge->isIncluded()}, edges, unitNogoods);
+    if (conflict != -1) {
+        const NogoodLiteral* literals = nogoods.getLiterals(conflict);
+        conflictReason = 0;
+        for (int i = 0; i < nogoods.getLength(conflict); i++) {
+            conflictReason |= edgeReason[literals[i].edgeId];
+        }
+        return false;
+    }
+    
+    // The open literal of a nogood whose other literals are all true must not become true
+    for (int nogood : unitNogoods) {
+        const NogoodLiteral* literals = nogoods.getLiterals(nogood);
+        uint64_t reason = 0;
+        for (int i = 1; i < nogoods.getLength(nogood); i++) {
+            reason |= edgeReason[literals[i].edgeId];
+        }
+        
+        Edge* forced = edges[literals[0].edgeId];
+        if (forced->isUndecided()) {
+            forced->setState(literals[0].included ? EXCLUDED : INCLUDED);
+            stampReasons(reason);
+        } else if (NogoodStore::isTrue(literals[0], forced)) {
+            // Set by an earlier nogood of this batch
+            conflictReason = reason | edgeReason[forced->id];
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TurnPuzzle::applyUnitNogoods() {
+    for (const NogoodLiteral& literal : nogoods.getUnitLiterals()) {
+        Edge* edge = edges[literal.edgeId];
+        if (edge->isUndecided()) {
+            edge->setState(literal.included ? EXCLUDED : INCLUDED);
+            stampReasons(0);
+        } else if (NogoodStore::isTrue(literal, edge)) {
+            conflictReason = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+void TurnPuzzle::learnNogood(uint64_t reason) {
+    // Newest decision first, so the nogood watches what backtracking undoes first
+    learnedLiterals.clear();
+    for (size_t level = decisionPath.size(); level > 0; level--) {
+        if (reason & levelBit(level)) {
+            const SearchDecision& decision = decisionPath[level - 1];
+            learnedLiterals.push_back({decision.edgeId, decision.state == INCLUDED});
+            if (learnedLiterals.size() > NogoodStore::MAX_LENGTH) {
+                return;
+            }
+        }
+    }
+    nogoods.add(learnedLiterals);
+}
+
+void TurnPuzzle::clearPropagationQueues() {
+    while (!cellQueue.empty()) {
+        cellQueued[cellIndex(cellQueue.front())] = false;
+        cellQueue.pop();
+    }
+    pathQueue.clear();
+    regionQueue.clear();
+    propagationCursor = trail.size();
+}
+
+bool TurnPuzzle::isOnHeadPath(const Cell* cell) const {
+    return cells[pathUnion.getEnd1(cell->id)]->cellType == HEAD ||
+           cells[pathUnion.getEnd2(cell->id)]->cellType == HEAD;
+}
+
+bool TurnPuzzle::checkRegions() {
+    // Every search in this pass gets its own generation; cells stamped by an earlier search of
+    // the same pass are known to reach a HEAD path
+    unsigned passGeneration = visitGeneration + 1;
+    
+    for (Cell* cell : regionQueue) {
+        if (!isOnHeadPath(cell) && !reachesHeadPath(cell, passGeneration)) {
+            // The region is closed off by its own decided edges, which also make up its paths
+            conflictReason = 0;
+            for (Cell* regionCell : regionSearch) {
+                conflictReason |= cellEdgesReason(regionCell);
+            }
+            regionQueue.clear();
+            return false;
+        }
+        if (visitGeneration < passGeneration) {
+            // The generation counter wrapped and cleared the stamps
+            passGeneration = visitGeneration;
+        }
+    }
+    regionQueue.clear();
+    return true;
+}
+
+bool TurnPuzzle::reachesHeadPath(Cell* start, unsigned passGeneration) {
+    if (start->visitStamp >= passGeneration && start->visitStamp <= visitGeneration) {
+        return true;
+    }
+    
+    // Flood the cells joined to start by INCLUDED or UNDECIDED edges until one lies on a HEAD path
+    resetVisitedFlags();
+    regionSearch.clear();
+    regionSearch.push_back(start);
+    markVisited(start);
+    
+    for (size_t i = 0; i < regionSearch.size(); i++) {
+        Cell* current = regionSearch[i];
+        if (isOnHeadPath(current)) {
+            return true;
+        }
+        
+        for (Edge* edge : current->edges) {
+            if (!edge->isUndecided() && !edge->isIncluded()) {
+                continue;
+            }
+            Cell* neighbor = (edge->cell1 == current) ? edge->cell2 : edge->cell1;
+            if (isVisited(neighbor)) {
+                continue;
+            }
+            if (neighbor->visitStamp >= passGeneration) {
+                // Reached by an earlier search of this pass, which found a HEAD path
+                return true;
+            }
+            markVisited(neighbor);
+            regionSearch.push_back(neighbor);
+        }
+    }
+    
+    return false;
+}
+
+Cell* TurnPuzzle::nextOnPath(Cell* current, Cell* previous) const {
+    for (Edge* edge : current->edges) {
+        if (edge->isIncluded()) {
+            Cell* otherCell = (edge->cell1 == current) ? edge->cell2 : edge->cell1;
+            if (otherCell != previous) {
+                return otherCell;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool TurnPuzzle::checkPathThrough(Cell* cell) {
+    // Walk to one end of the path
+    Cell* previous = nullptr;
+    Cell* start = cell;
+    while (Cell* next = nextOnPath(start, previous)) {
+        if (next == cell) {
+            // Closed loop - there is no end to check from
+            return true;
+        }
+        previous = start;
+        start = next;
+    }
+    
+    // Walk back to the other end, collecting the turns on the way
+    TurnSignature signature;
+    previous = nullptr;
+    Cell* end = start;
+    while (Cell* next = nextOnPath(end, previous)) {
+        signature.addStep(TurnSignature::directionBetween(end, next));
+        previous = end;
+        end = next;
+    }
+    
+    // A path may not run from one HEAD to another
+    if (end != start && start->cellType == HEAD && end->cellType == HEAD) {
+        return false;
+    }
+    
+    // Every path becomes part of a HEAD path, so mixed turns can never be fixed
+    return signature.getTurnType() != RIGHT_LEFT_MIXED;
+}
+
+void TurnPuzzle::setBranchStrategy(TurnPuzzleTypes::BranchStrategy strategy) {
+    branchStrategy = strategy;
+}
+
+long long TurnPuzzle::getSearchNodes() const {
+    return searchNodes;
+}
+
+long long TurnPuzzle::getProbes() const {
+    return probeCount;
+}
+
+void TurnPuzzle::setProbeBudget(int edgesPerNode) {
+    probeBudget = edgesPerNode < 0 ? 0 : edgesPerNode;
+}
+
+int TurnPuzzle::searchDifferentSolution(int solutionNumber) {
+    const bool restarts = branchStrategy == TurnPuzzleTypes::BranchStrategy::RANDOM_RESTARTS;
+    long long attemptLimit = 1000;
+    long long nodesBefore = searchNodes;
+    searchWalls.clear();
+    
+    if (restarts) {
+        branchOrder = edges;
+        std::shuffle(branchOrder.begin(), branchOrder.end(), branchRng);
+    }
+    
+    while (true) {
+        // Record every change made by the search so it can backtrack cheaply
+        trail.clear();
+        setEdgeTrail(&trail);
+        setEdgeHash(&stateHash);
+        resetSearchIndexes();
+        
+        // The first propagation has to look at every cell once
+        propagationCursor = 0;
+        for (Cell* cell : cells) {
+            enqueueCell(cell);
+        }
+        
+        attemptStartNodes = searchNodes;
+        nodeLimit = restarts ? attemptLimit : 0;
+        searchAborted = false;
+        decisionPath.clear();
+        wallMark = 0;
+        
+        int diffIndex = FindDifferentSolution(solutionNumber);
+        while (pendingWall != nullptr) {
+            // The wall edge was forced by the root propagation, which has to run again
+            applyPendingWall(0);
+            for (Cell* cell : cells) {
+                enqueueCell(cell);
+            }
+            diffIndex = FindDifferentSolution(solutionNumber);
+        }
+        setEdgeTrail(nullptr);
+        setEdgeHash(nullptr);
+        trail.clear();
+        
+        if (!searchAborted) {
+            *console << "Search nodes: " << (searchNodes - nodesBefore) << std::endl;
+            return diffIndex;
+        }
+        
+        // Restart from the root with a new edge order and twice the node budget
+        clearPropagationQueues();
+        for (Edge* edge : edges) {
+            if (!edge->isDeleted()) {
+                edge->setState(UNDECIDED);
+            }
+        }
+        attemptLimit *= 2;
+        std::shuffle(branchOrder.begin(), branchOrder.end(), branchRng);
+    }
+}
+
+bool TurnPuzzle::probeEdges() {
+    // Probe the edges that could extend an open path end
+    probeCandidates.clear();
+    for (Cell* cell : cells) {
+        int openDegree = cell->cellType == HEAD ? 0 : 1;
+        if (cell->getDegree() != openDegree) {
+            continue;
+        }
+        for (Edge* edge : cell->edges) {
+            if (edge->isUndecided() && static_cast<int>(probeCandidates.size()) < probeBudget &&
+                std::find(probeCandidates.begin(), probeCandidates.end(), edge) == probeCandidates.end()) {
+                probeCandidates.push_back(edge);
+            }
+        }
+        if (static_cast<int>(probeCandidates.size()) == probeBudget) {
+            break;
+        }
+    }
+    
+    // A probe is a decision one level down that is undone straight away
+    const size_t level = decisionPath.size() + 1;
+    const uint64_t ownBit = level < 64 ? levelBit(level) : 0;
+    
+    for (Edge* edge : probeCandidates) {
+        for (EdgeState value : {INCLUDED, EXCLUDED}) {
+            if (!edge->isUndecided()) {
+                break;
+            }
+            
+            size_t probeMark = trail.size();
+            decisionPath.push_back({edge->id, value});
+            edge->setState(value);
+            stampReasons(levelBit(level));
+            probeCount++;
+            bool failed = propagate() == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+            decisionPath.pop_back();
+            backtrack(probeMark);
+            if (!failed) {
+                continue;
+            }
+            
+            // The other value follows from what the probe failed on
+            edge->setState(value == INCLUDED ? EXCLUDED : INCLUDED);
+            stampReasons(conflictReason & ~ownBit);
+            if (propagate() == TurnPuzzleTypes::SolveOutput::SOLVE_FAILED) {
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+Edge* TurnPuzzle::selectBranchEdge() {
+    switch (branchStrategy) {
+        case TurnPuzzleTypes::BranchStrategy::MOST_CONSTRAINED_CELL: {
+            // The cell with the fewest UNDECIDED edges has the fewest ways to go wrong
+            Edge* bestEdge = nullptr;
+            int bestCount = 5;
+            for (Cell* cell : cells) {
+                int undecidedCount = 0;
+                Edge* firstUndecided = nullptr;
+                for (Edge* edge : cell->edges) {
+                    if (edge->isUndecided()) {
+                        if (firstUndecided == nullptr) {
+                            firstUndecided = edge;
+                        }
+                        undecidedCount++;
+                    }
+                }
+                if (firstUndecided != nullptr && undecidedCount < bestCount) {
+                    bestEdge = firstUndecided;
+                    bestCount = undecidedCount;
+                }
+            }
+            return bestEdge;
+        }
+        
+        case TurnPuzzleTypes::BranchStrategy::LONGEST_OPEN_PATH: {
+            // Extend the open path end that belongs to the longest path
+            Edge* bestEdge = nullptr;
+            int bestLength = 0;
+            for (Cell* cell : cells) {
+                if (cell->getDegree() != 1) {
+                    continue;
+                }
+                
+                Edge* firstUndecided = nullptr;
+                for (Edge* edge : cell->edges) {
+                    if (edge->isUndecided()) {
+                        firstUndecided = edge;
+                        break;
+                    }
+                }
+                if (firstUndecided == nullptr) {
+                    continue;
+                }
+                
+                int length = 1;
+                Cell* previous = nullptr;
+                Cell* current = cell;
+                while (Cell* next = nextOnPath(current, previous)) {
+                    previous = current;
+                    current = next;
+                    length++;
+                }
+                
+                if (length > bestLength) {
+                    bestEdge = firstUndecided;
+                    bestLength = length;
+                }
+            }
+            if (bestEdge != nullptr) {
+                return bestEdge;
+            }
+            break;  // No open path yet - fall back to edge order
+        }
+        
+        case TurnPuzzleTypes::BranchStrategy::RANDOM_RESTARTS:
+            for (Edge* edge : branchOrder) {
+                if (edge->isUndecided()) {
+                    return edge;
+                }
+            }
+            return nullptr;
+        
+        case TurnPuzzleTypes::BranchStrategy::FIRST_UNDECIDED:
+            break;
+    }
+    
+    // First undecided edge in edge order
+    for (Edge* edge : edges) {
+        if (edge->isUndecided()) {
+            return edge;
+        }
+    }
+    return nullptr;
+}
+
+void TurnPuzzle::setSearchThreads(int threads) {
+    searchThreads = threads < 1 ? 1 : threads;
+    warnParallelOverrides(true, true);
+}
+
+void TurnPuzzle::setIncrementalSearch(bool incremental) {
+    incrementalSearch = incremental;
+    warnParallelOverrides(true, false);
+}
+
+void TurnPuzzle::warnParallelOverrides(bool checkIncremental, bool checkEngine) const {
+    // runSearch takes the parallel search first; its workers always run the object engine from scratch
+    if (searchThreads <= 1) {
+        return;
+    }
+    if (checkIncremental && incrementalSearch) {
+        std::cerr << "Incremental search is not supported with " << searchThreads
+                  << " search threads, using the parallel search" << std::endl;
+    }
+    if (checkEngine && solverEngine == TurnPuzzleTypes::SolverEngine::BITBOARD) {
+        std::cerr << "Bitboard engine is not supported with " << searchThreads
+                  << " search threads, using the parallel search" << std::endl;
+    }
+}
+
+void TurnPuzzle::addPendingWall(int diffIndex, int solutionNumber) {
+    int number = solutionNumber + static_cast<int>(searchWalls.size());
+    reportDifferentSolution(number);
+    *console << "Solution #" << (number + 1) << " differs at edge index: " << diffIndex << std::endl;
+    
+    // Earlier nodes never saw the edge INCLUDED; the newest one of them is where the search resumes
+    pendingWall = edges[diffIndex];
+    pendingWallPosition = 0;
+    for (size_t i = trail.size(); i > 0; i--) {
+        if (trail.getEntry(i - 1).edge == pendingWall) {
+            pendingWallPosition = i - 1;
+            break;
+        }
+    }
+    searchWalls.push_back(pendingWall);
+}
+
+bool TurnPuzzle::applyPendingWall(size_t trailMark) {
+    if (trailMark > pendingWallPosition) {
+        return false;
+    }
+    
+    backtrack(trailMark);
+    
+    // Set the wall without recording it, so backtracking above this node keeps it
+    pendingWall->trail = nullptr;
+    pendingWall->setState(DELETED);
+    pendingWall->trail = &trail;
+    edgeReason[pendingWall->id] = 0;
+    enqueueCell(pendingWall->cell1);
+    enqueueCell(pendingWall->cell2);
+    updateTailState(pendingWall->cell1);
+    updateTailState(pendingWall->cell2);
+    wallMark = trailMark;
+    
+    *console << "Marked edge " << pendingWall->id << " as DELETED, resuming search..." << std::endl;
+    pendingWall = nullptr;
+    return true;
+}
+
+void TurnPuzzle::reportDifferentSolution(int solutionNumber) {
+    *console << "Found different solution!" << std::endl;
+    
+    if (!solutionExport) {
+        return;
+    }
+    
+    // Create unique filename for this solution
+    std::string filename = outputPrefix + "differentSolution" + std::to_string(solutionNumber + 1) + ".svg";
+    exportToSVG(filename);
+}
+
+int TurnPuzzle::searchDifferentSolutionParallel(int solutionNumber) {
+    // Workers copy the edge order, so shuffle it once up front
+    if (branchStrategy == TurnPuzzleTypes::BranchStrategy::RANDOM_RESTARTS) {
+        branchOrder = edges;
+        std::shuffle(branchOrder.begin(), branchOrder.end(), branchRng);
+    }
+    
+    ParallelSearch search(*this, searchThreads);
+    int diffIndex = search.run(solutionNumber);
+    searchNodes += search.getSearchNodes();
+    probeCount += search.getProbes();
+    *console << "Search nodes: " << search.getSearchNodes() << " on " << searchThreads << " threads" << std::endl;
+    
+    // Bring the winning worker's solution back for export
+    if (const TurnPuzzle* winner = search.getWinner()) {
+        for (size_t i = 0; i < edges.size(); i++) {
+            edges[i]->setState(winner->edges[i]->state);
+        }
+        reportDifferentSolution(solutionNumber);
+    }
+    return diffIndex;
+}
+
+void TurnPuzzle::setTranspositionMemory(size_t megabytes) {
+    transpositions.resize(megabytes);
+}
+
+void TurnPuzzle::setSolutionCounting(bool counting) {
+    if (counting && gridSize > SolutionCounter::MAX_WIDTH) {
+        std::cerr << "Solution counting supports grids up to " << SolutionCounter::MAX_WIDTH
+                  << " wide, searching without it" << std::endl;
+        return;
+    }
+    solutionCounting = counting;
+}
+
+uint64_t TurnPuzzle::countSolutions() const {
+    SolutionCounter counter(*this);
+    uint64_t count = counter.count();
+    *console << "Exact solution count: " << count << " (" << counter.getPeakStates()
+              << " frontier states at most)" << std::endl;
+    return count;
+}
+
+void TurnPuzzle::setSeed(uint32_t puzzleSeed) {
+    seed = puzzleSeed;
+    seeded = true;
+}
+
+int TurnPuzzle::getWallCount() const {
+    int walls = 0;
+    for (const Edge* edge : edges) {
+        if (edge->isDeleted()) {
+            walls++;
+        }
+    }
+    return walls;
+}
+
+void TurnPuzzle::setSolverEngine(TurnPuzzleTypes::SolverEngine engine) {
+    if (engine == TurnPuzzleTypes::SolverEngine::BITBOARD && gridSize > BitboardEngine::MAX_SIZE) {
+        std::cerr << "Bitboard engine supports grids up to " << BitboardEngine::MAX_SIZE
+                  << "x" << BitboardEngine::MAX_SIZE << ", using the object engine" << std::endl;
+        return;
+    }
+    solverEngine = engine;
+    warnParallelOverrides(false, true);
+}
+
+int TurnPuzzle::searchDifferentSolutionBitboard(int solutionNumber) {
+    BitboardEngine engine(*this);
+    int diffIndex = engine.run();
+    searchNodes += engine.getSearchNodes();
+    *console << "Search nodes: " << engine.getSearchNodes() << " (bitboard)" << std::endl;
+    
+    if (diffIndex != -1) {
+        engine.copySolutionTo(*this);
+        reportDifferentSolution(solutionNumber);
+    }
+    return diffIndex;
+}
+
+int TurnPuzzle::runSearchTask(const std::vector<SearchDecision>& decisions, int solutionNumber) {
+    // Start from the root state of the search
+    setEdgeTrail(nullptr);
+    for (Edge* edge : edges) {
+        if (!edge->isDeleted()) {
+            edge->setState(UNDECIDED);
+        }
+    }
+    trail.clear();
+    setEdgeTrail(&trail);
+    resetSearchIndexes();
+    clearPropagationQueues();
+    for (Cell* cell : cells) {
+        enqueueCell(cell);
+    }
+    searchAborted = false;
+    nodeLimit = 0;
+    decisionPath.clear();
+    
+    // Replay the decisions that lead to the task's subtree; propagation is deterministic,
+    // so this reproduces the state the task was created in
+    bool consistent = propagate() != TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+    for (size_t i = 0; consistent && i < decisions.size(); i++) {
+        Edge* edge = edges[decisions[i].edgeId];
+        if (edge->isUndecided()) {
+            edge->setState(decisions[i].state);
+        } else if (edge->state != decisions[i].state) {
+            consistent = false;
+            break;
+        }
+        decisionPath.push_back(decisions[i]);
+        stampReasons(levelBit(decisionPath.size()));
+        consistent = propagate() != TurnPuzzleTypes::SolveOutput::SOLVE_FAILED;
+    }
+    
+    int result = consistent ? FindDifferentSolution(solutionNumber) : -1;
+    setEdgeTrail(nullptr);
+    return result;
 }
@@ -1,12 +1,22 @@
 #ifndef TURNPUZZLE_H
 #define TURNPUZZLE_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <fstream>
+#include <iostream>
+#include <queue>
+#include <random>
 #include "Path.h"
+#include "PathRegistry.h"
+#include "PathUnionFind.h"
+#include "NogoodStore.h"
+#include "TranspositionTable.h"
 #include "Cell.h"
 #include "Edge.h"
+#include "Trail.h"
+#include "ParallelSearch.h"
 #include "DataTypes.h"
 
 // Direction enum for cell connections (bitmask)
@@ -20,8 +30,14 @@ enum Direction {
 
 class TurnPuzzle {
 public:
-    // Constructor
-    TurnPuzzle(int size);
+    // Constructor. The debug log and SVG files get filePrefix in front of their names, and
+    // progress messages go to output. Without debugLog no debug.log is created at all.
+    TurnPuzzle(int size, const std::string& filePrefix = "", std::ostream& output = std::cout,
+               bool debugLog = true);
+    
+    // Puzzles own their log file and grid pointers; ParallelSearch makes its worker copies explicitly
+    TurnPuzzle(const TurnPuzzle&) = delete;
+    TurnPuzzle& operator=(const TurnPuzzle&) = delete;
     
     // Destructor
     ~TurnPuzzle();
@@ -31,32 +47,165 @@ public:
     void exportToSVG(const std::string& filename) const;
     int getSize() const;
     void printSolution() const;
-    void resetVisitedFlags();
+    void resetVisitedFlags();  // Starts a new traversal in O(1)
     void findPath(Cell* startCell, Path& path);
-    bool findPaths(std::vector<Path>& paths);
+    bool tracePaths(PathBuffer& buffer);  // Writes every HEAD path, false if one is invalid
+    PathValidation validatePaths();  // Checks the HEAD paths without storing them
+    bool isSolutionCovered();  // After markCells: the solution's HEAD paths are valid and reach every cell
     void markCells();
     bool GeneratePuzzle();  // Generates solution, marks cells, and checks for different solution
-    void solvePuzzle();  // Tries to find different valid solutions
+    void solvePuzzle();  // Tries to find different valid solutions, adding a wall for each
+    void exportProblem() const;  // Writes the puzzle with its walls to problem.svg
+    // Replace the HEAD cells and walls (by cell and edge id) and forget the solution, so one object
+    // can check many puzzles of its size
+    void loadPuzzle(const std::vector<int>& headCells, const std::vector<int>& wallEdges);
+    // Search the loaded puzzle for a solution, then for a different one. Returns 0 for no solution,
+    // 1 for a unique one and 2 for more than one; the first solution found is left in solution.
+    int checkUniqueness(std::vector<EdgeState>& solution);
     int FindDifferentSolution(int solutionNumber);  // Tries to find a different valid solution, returns edge index or -1
-    TurnPuzzleTypes::SolveOutput SolveCells();  // Calls Solve() on each cell
     bool isSolved();  // Checks if puzzle is solved (HEAD degree=1, others degree=2)
+    void setBranchStrategy(TurnPuzzleTypes::BranchStrategy strategy);  // How the solver picks edges to branch on
+    long long getSearchNodes() const;  // Nodes visited by the last solvePuzzle()
+    long long getProbes() const;  // Probe propagations run by the last solvePuzzle()
+    void setSearchThreads(int threads);  // Worker threads for the uniqueness search, 1 = sequential
+    void setIncrementalSearch(bool incremental);  // Keep searching after each wall instead of restarting
+    void setSolverEngine(TurnPuzzleTypes::SolverEngine engine);  // Data layout of the sequential search
+    void setTranspositionMemory(size_t megabytes);  // Memory cap of the transposition table, 0 disables it
+    void setProbeBudget(int edgesPerNode);  // Edges probed at every search node before branching, 0 disables probing
+    void setSolutionCounting(bool counting);  // Settle uniqueness with SolutionCounter before each search
+    uint64_t countSolutions() const;  // Exact number of solutions with the current walls
+    void setSeed(uint32_t seed);  // Makes generateSolution and markCells reproducible
+    int getWallCount() const;  // DELETED edges left by the last solvePuzzle()
     
 private:
+    // Selects the worker copy constructor
+    struct WorkerTag {};
+    
+    // Copy of another puzzle's grid and solution, used as a private search worker by ParallelSearch
+    // (no log or console output, empty transposition table and nogoods)
+    TurnPuzzle(const TurnPuzzle& other, WorkerTag);
+    
     // Private member variables
     int gridSize;
+    std::string outputPrefix;
+    std::ostream* console;
+    uint32_t seed;
+    bool seeded;  // Without a seed, markCells picks new HEAD cells on every run
+    std::vector<Cell> cellStorage;  // Contiguous storage behind cells, never resized after initializeGrid
+    std::vector<Edge> edgeStorage;  // Contiguous storage behind edges, never resized after initializeEdges
     std::vector<Cell*> cells;  // Flat array of all cells
     std::vector<Edge*> edges;               // All edges
+    unsigned visitGeneration;  // Cells whose visitStamp equals this were visited by the current traversal
     std::vector<EdgeState> originalSolution;  // Original solution edge states
+    PathRegistry pathRegistry;  // Endpoints of the partial paths built by generateSolution
+    std::vector<Edge*> addableEdges;   // Edges generateSolution can currently add
+    std::vector<int> candidatePosition;  // Position of each edge in addableEdges, -1 if absent
     std::ofstream logFile;  // Log file for debugging
+    Trail trail;  // Undo log of edge changes made by FindDifferentSolution
+    size_t propagationCursor;  // First trail entry not yet seen by propagate()
+    PathUnionFind pathUnion;  // Paths formed by the INCLUDED edges propagate() has seen
+    std::vector<char> tailState;  // Per cell: 2 = certain tail, 1 = could still become a tail, 0 = cannot
+    int certainTails;    // UNMARKED cells with degree 1 and no UNDECIDED edge left
+    int possibleTails;   // UNMARKED cells with degree 0 or 1, including the certain tails
+    int headCount;
+    std::vector<Edge*> undoneEdges;  // Scratch list of backtrack()
+    // Reasons are sets of decision levels, bit i standing for level i + 1 (the last bit also covers
+    // every deeper level). An edge's reason holds the decisions its current state follows from.
+    std::vector<uint64_t> edgeReason;
+    size_t reasonCursor;  // First trail entry whose edge has no reason yet
+    uint64_t conflictReason;  // Decisions the last failed propagation or subtree depends on
+    NogoodStore nogoods;  // Learned by FindDifferentSolution, kept for every search of the same puzzle
+    std::vector<int> unitNogoods;  // Scratch list of propagateNogoods()
+    std::vector<NogoodLiteral> learnedLiterals;  // Scratch list of learnNogood()
+    uint64_t stateHash;  // Zobrist hash of the edge states while the sequential search runs
+    TranspositionTable transpositions;  // States of the same puzzle proven to have no different solution
+    std::queue<Cell*> cellQueue;  // Cells waiting for Cell::Solve()
+    std::vector<char> cellQueued;  // Whether each cell is already in cellQueue
+    std::vector<Cell*> pathQueue;  // Cells whose path grew and needs re-checking
+    std::vector<Cell*> regionQueue;  // Cells next to a newly EXCLUDED edge, whose region needs re-checking
+    std::vector<Cell*> regionSearch;  // Scratch queue of reachesHeadPath()
+    TurnPuzzleTypes::BranchStrategy branchStrategy;
+    std::vector<Edge*> branchOrder;  // Edge order used by RANDOM_RESTARTS
+    std::mt19937 branchRng;
+    long long searchNodes;  // FindDifferentSolution calls since solvePuzzle() started
+    int probeBudget;
+    long long probeCount;  // Probe propagations since solvePuzzle() started
+    std::vector<Edge*> probeCandidates;  // Scratch list of probeEdges()
+    long long attemptStartNodes;  // searchNodes when the current restart attempt began
+    long long nodeLimit;  // Nodes allowed per restart attempt, 0 for no limit
+    bool searchAborted;  // Set when an attempt hits nodeLimit or a parallel search is cancelled
+    std::vector<SearchDecision> decisionPath;  // Branching decisions from the root to the current node
+    std::vector<EdgeState> solvedStates;  // Reused by FindDifferentSolution to compare a solution
+    PathBuffer reportedPaths;  // Reused by isSolved to print the solution's paths
+    int searchThreads;
+    bool workerCopy;  // True for the copies searched by ParallelSearch workers
+    ParallelSearch* parallelSearch;  // Set on worker copies only
+    int workerIndex;
+    bool incrementalSearch;
+    bool solutionCounting;
+    bool solutionExport;  // Whether reportDifferentSolution writes an SVG
+    TurnPuzzleTypes::SolverEngine solverEngine;
+    std::vector<Edge*> searchWalls;  // Walls added by the running incremental search, kept off the trail
+    Edge* pendingWall;  // Newest wall while the search unwinds to a node where it is still UNDECIDED
+    size_t pendingWallPosition;  // Trail position at which pendingWall was INCLUDED
+    size_t wallMark;  // Trail position the search walls were last propagated from
     
     // Helper functions
     void initializeGrid();
     void initializeEdges();
     Cell* getCell(int row, int col) const;  // Access cell by row/col
+    int cellIndex(const Cell* cell) const;  // Index of a cell in the flat array
+    bool isVisited(const Cell* cell) const;
+    void markVisited(Cell* cell);
+    Edge* getEdge(int row, int col, TurnPuzzleTypes::Direction direction) const;  // nullptr at the border
+    Edge* edgeBetween(const Cell* first, const Cell* second) const;  // The cells must be adjacent
     void SaveEdgeStates(std::vector<EdgeState>& edgeStates);
-    void RestoreEdgeStates(const std::vector<EdgeState>& edgeStates);
+    void setEdgeTrail(Trail* edgeTrail);  // Attach (or detach with nullptr) the undo log to every edge
+    void setEdgeHash(uint64_t* hash);  // Attach (or detach with nullptr) a Zobrist hash to every edge and recompute it
+    void backtrack(size_t trailMark);  // Undo the search back to a trail position
+    void enqueueCell(Cell* cell);
+    TurnPuzzleTypes::SolveOutput propagate();  // Run Cell::Solve() on queued cells until nothing changes
+    void clearPropagationQueues();
+    void resetSearchIndexes();  // Rebuild pathUnion and the tail counts for a search root without INCLUDED edges
+    void updateTailState(Cell* cell);
+    TurnPuzzleTypes::SolveOutput checkTailBudget();  // Every HEAD path needs exactly one tail
+    bool joinPaths(Edge* edge, size_t trailPosition);  // False if the INCLUDED edge closes a loop
+    uint64_t levelBit(size_t level) const;
+    uint64_t levelsUpTo(size_t level) const;  // Reason of a rule that looks at the whole grid
+    void stampReasons(uint64_t reason);  // Give the edges changed since reasonCursor a reason
+    uint64_t cellEdgesReason(const Cell* cell) const;  // Union of the reasons of the cell's decided edges
+    uint64_t solveReason(const Cell* cell) const;  // What Cell::Solve() looked at
+    uint64_t tailReason(char state) const;  // Union of the cellEdgesReason of the cells in a tail state
+    bool propagateNogoods(Edge* edge);  // False, with conflictReason set, if a nogood became true
+    bool applyUnitNogoods();
+    void learnNogood(uint64_t reason);  // Store the decisions in reason as a nogood
+    Cell* nextOnPath(Cell* current, Cell* previous) const;
+    bool isOnHeadPath(const Cell* cell) const;
+    bool checkRegions();  // False if a cell in regionQueue can no longer reach a HEAD path
+    bool reachesHeadPath(Cell* start, unsigned passGeneration);
+    int walkHeadPath(Cell* head, TurnSignature& signature, Cell*& end, std::vector<int>* cellIndices);
+    bool checkPathThrough(Cell* cell);  // False if the cell's path is HEAD-to-HEAD or has mixed turns
+    int runSearch(int solutionNumber);  // The search of the chosen engine and thread count
+    int searchDifferentSolution(int solutionNumber);  // Runs FindDifferentSolution from the root, with restarts if enabled
+    Edge* selectBranchEdge();
+    bool probeEdges();  // False, with conflictReason set, if probing shows the node has no solution
+    int searchDifferentSolutionParallel(int solutionNumber);
+    int searchDifferentSolutionBitboard(int solutionNumber);
+    int runSearchTask(const std::vector<SearchDecision>& decisions, int solutionNumber);  // Replay decisions, then search below them
+    void reportDifferentSolution(int solutionNumber);
+    void addPendingWall(int diffIndex, int solutionNumber);
+    void warnParallelOverrides(bool checkIncremental, bool checkEngine) const;  // Settings the parallel search ignores
+    bool applyPendingWall(size_t trailMark);  // False if the wall has to be applied further up
+    
+    friend class ParallelSearch;
+    friend class BitboardEngine;
+    friend class SolutionCounter;
+    friend class PuzzleCorpus;
+    friend class PuzzleCorpusReader;
+    friend class StreamSolver;
     int FindDifferentEdge(const std::vector<EdgeState>& first, const std::vector<EdgeState>& second);
     bool canAddEdge(const Edge& edge);
+    void refreshCandidate(Edge* edge);  // Insert or remove an edge from addableEdges
     bool tryConnectHeadToTail(Cell* head, Cell* tail, std::vector<Cell*>& unpairedHeads, std::vector<Cell*>& unpairedTails);
     bool findPathBetween(Cell* start, Cell* end, Path& path);
 };
@@ -1,22 +1,253 @@
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
+#include "BatchGenerator.h"
+#include "PuzzleCorpus.h"
+#include "PuzzlePipeline.h"
+#include "StreamSolver.h"
 #include "TurnPuzzle.h"
 
-int main() {
+// Parse the value of --pipeline=<generate>,<mark>,<verify>,<export> worker counts
+static bool parseStageWorkers(const std::string& value, int (&stageWorkers)[STAGE_COUNT]) {
+    size_t start = 0;
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        size_t end = value.find(',', start);
+        if ((end == std::string::npos) != (stage == STAGE_COUNT - 1)) {
+            return false;
+        }
+        stageWorkers[stage] = std::atoi(value.substr(start, end - start).c_str());
+        if (stageWorkers[stage] < 1) {
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+// Parse the value of --branch=<name>, returns false for unknown names
+static bool parseBranchStrategy(const std::string& name, TurnPuzzleTypes::BranchStrategy& strategy) {
+    if (name == "first") {
+        strategy = TurnPuzzleTypes::BranchStrategy::FIRST_UNDECIDED;
+    } else if (name == "cell") {
+        strategy = TurnPuzzleTypes::BranchStrategy::MOST_CONSTRAINED_CELL;
+    } else if (name == "path") {
+        strategy = TurnPuzzleTypes::BranchStrategy::LONGEST_OPEN_PATH;
+    } else if (name == "random") {
+        strategy = TurnPuzzleTypes::BranchStrategy::RANDOM_RESTARTS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    TurnPuzzleTypes::BranchStrategy branchStrategy = TurnPuzzleTypes::BranchStrategy::FIRST_UNDECIDED;
+    int searchThreads = 1;
+    bool incrementalSearch = false;
+    TurnPuzzleTypes::SolverEngine solverEngine = TurnPuzzleTypes::SolverEngine::OBJECT_GRAPH;
+    int transpositionMegabytes = 16;
+    int probeBudget = 0;
+    bool solutionCounting = false;
+    int batchCount = 0;
+    int batchThreads = 1;
+    long long seed = -1;
+    bool pipelined = false;
+    std::string corpusPath;
+    std::string solvePath;
+    int stageWorkers[STAGE_COUNT];
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--branch=", 0) == 0 && parseBranchStrategy(arg.substr(9), branchStrategy)) {
+            continue;
+        }
+        if (arg == "--engine=object" || arg == "--engine=bitboard") {
+            solverEngine = arg == "--engine=bitboard" ? TurnPuzzleTypes::SolverEngine::BITBOARD
+                                                      : TurnPuzzleTypes::SolverEngine::OBJECT_GRAPH;
+            continue;
+        }
+        if (arg == "--count") {
+            solutionCounting = true;
+            continue;
+        }
+        if (arg == "--incremental") {
+            incrementalSearch = true;
+            continue;
+        }
+        if (arg.rfind("--tt-mb=", 0) == 0) {
+            transpositionMegabytes = std::atoi(arg.c_str() + 8);
+            if (transpositionMegabytes >= 0) {
+                continue;
+            }
+        }
+        if (arg.rfind("--probes=", 0) == 0) {
+            probeBudget = std::atoi(arg.c_str() + 9);
+            if (probeBudget >= 0) {
+                continue;
+            }
+        }
+        if (arg.rfind("--batch=", 0) == 0) {
+            batchCount = std::atoi(arg.c_str() + 8);
+            if (batchCount >= 1) {
+                continue;
+            }
+        }
+        if (arg.rfind("--jobs=", 0) == 0) {
+            batchThreads = std::atoi(arg.c_str() + 7);
+            if (batchThreads >= 1) {
+                continue;
+            }
+        }
+        if (arg.rfind("--pipeline=", 0) == 0 && parseStageWorkers(arg.substr(11), stageWorkers)) {
+            pipelined = true;
+            continue;
+        }
+        if (arg.rfind("--corpus=", 0) == 0 && arg.size() > 9) {
+            corpusPath = arg.substr(9);
+            continue;
+        }
+        if (arg.rfind("--solve=", 0) == 0 && arg.size() > 8) {
+            solvePath = arg.substr(8);
+            continue;
+        }
+        if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::atoll(arg.c_str() + 7);
+            if (seed >= 0 && seed <= 0xffffffffLL) {
+                continue;
+            }
+        }
+        if (arg.rfind("--threads=", 0) == 0) {
+            searchThreads = std::atoi(arg.c_str() + 10);
+            if (searchThreads >= 1) {
+                continue;
+            }
+        }
+        std::cerr << "Unknown argument: " << arg << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [--branch=first|cell|path|random] [--threads=N] [--incremental]"
+                  << " [--engine=object|bitboard] [--tt-mb=N] [--probes=N] [--count]"
+                  << " [--seed=N] [--batch=N] [--jobs=N] [--pipeline=G,M,V,E]"
+                  << " [--corpus=FILE] [--solve=FILE|-]" << std::endl;
+        return 1;
+    }
+
+    // Results go to stdout one line per puzzle, so nothing else is printed there
+    if (!solvePath.empty()) {
+        StreamSolver solver(std::cout);
+        solver.setBranchStrategy(branchStrategy);
+        solver.setSearchThreads(searchThreads);
+        solver.setSolverEngine(solverEngine);
+        solver.setTranspositionMemory(transpositionMegabytes);
+        solver.setProbeBudget(probeBudget);
+
+        long long puzzles = solver.run(solvePath);
+        if (puzzles < 0) {
+            return 1;
+        }
+        std::cerr << "Checked " << puzzles << " puzzles, " << solver.getUnique() << " unique" << std::endl;
+        return 0;
+    }
+
     std::cout << "Turn Puzzle Generator" << std::endl;
     std::cout << "=====================" << std::endl;
-    
+
+    if (batchCount > 0) {
+        BatchSettings settings;
+        settings.puzzleCount = batchCount;
+        settings.threads = batchThreads;
+        settings.firstSeed = seed >= 0 ? static_cast<uint32_t>(seed) : 1;
+        settings.branchStrategy = branchStrategy;
+        settings.incrementalSearch = incrementalSearch;
+        settings.solverEngine = solverEngine;
+        settings.transpositionMegabytes = transpositionMegabytes;
+        settings.probeBudget = probeBudget;
+        settings.solutionCounting = solutionCounting;
+
+        std::vector<BatchResult> results;
+        std::vector<StageMetrics> metrics;
+        if (pipelined) {
+            std::cout << "Generating " << batchCount << " puzzles in a pipeline" << std::endl;
+            PuzzlePipeline pipeline(settings, stageWorkers);
+            results = pipeline.run();
+            metrics = pipeline.getMetrics();
+        } else {
+            std::cout << "Generating " << batchCount << " puzzles on " << batchThreads << " threads" << std::endl;
+            BatchGenerator generator(settings);
+            results = generator.run();
+        }
+
+        long long totalNodes = 0;
+        int skipped = 0;
+        for (const BatchResult& result : results) {
+            if (!result.covered) {
+                std::cout << "Puzzle " << result.index << ": seed " << result.seed
+                          << " skipped, its solution leaves cells off every HEAD path -> " << result.filePrefix
+                          << "solution.svg" << std::endl;
+                skipped++;
+                continue;
+            }
+            std::cout << "Puzzle " << result.index << ": seed " << result.seed << ", " << result.walls
+                      << " walls, " << result.searchNodes << " search nodes -> " << result.filePrefix
+                      << "problem.svg" << std::endl;
+            totalNodes += result.searchNodes;
+        }
+        std::cout << "Total search nodes: " << totalNodes << std::endl;
+        if (skipped > 0) {
+            std::cout << "Skipped " << skipped << " puzzles without a solution" << std::endl;
+        }
+
+        // Records go into the corpus in puzzle order, however the threads finished
+        if (!corpusPath.empty()) {
+            PuzzleCorpusWriter corpus;
+            if (!corpus.open(corpusPath, settings.gridSize)) {
+                return 1;
+            }
+            for (const BatchResult& result : results) {
+                if (result.covered) {
+                    corpus.append(result.record);
+                }
+            }
+            std::cout << "Appended " << (results.size() - skipped) << " puzzles to " << corpusPath << std::endl;
+        }
+        for (const StageMetrics& stage : metrics) {
+            std::cout << "Stage " << stage.name << ": " << stage.workers << " workers, " << stage.puzzles
+                      << " puzzles, " << stage.capacityPerSecond << " puzzles/s capacity, "
+                      << stage.puzzlesPerSecond << " puzzles/s overall, " << stage.busySeconds
+                      << " s busy, queue depth " << stage.averageQueueDepth << " average, "
+                      << stage.maxQueueDepth << " max" << std::endl;
+        }
+        std::cout << "\nDone!" << std::endl;
+        return 0;
+    }
+
     const int maxAttempts = 1;
     bool foundDifferentSolution = false;
-    
+
     for (int attempt = 1; attempt <= maxAttempts; attempt++) {
         std::cout << "\n--- Attempt " << attempt << " ---" << std::endl;
-        
+
         // Create a 8x8 puzzle
         TurnPuzzle puzzle(6);
-        
+        puzzle.setBranchStrategy(branchStrategy);
+        puzzle.setSearchThreads(searchThreads);
+        puzzle.setIncrementalSearch(incrementalSearch);
+        puzzle.setSolverEngine(solverEngine);
+        puzzle.setTranspositionMemory(transpositionMegabytes);
+        puzzle.setProbeBudget(probeBudget);
+        puzzle.setSolutionCounting(solutionCounting);
+        if (seed >= 0) {
+            puzzle.setSeed(static_cast<uint32_t>(seed));
+        }
+
         // Generate puzzle and test for different solution
         bool hasDifferentSolution = puzzle.GeneratePuzzle();
-        
+
+        if (!corpusPath.empty()) {
+            PuzzleCorpusWriter corpus;
+            if (corpus.open(corpusPath, puzzle.getSize()) && corpus.append(puzzle)) {
+                std::cout << "Appended puzzle to " << corpusPath << std::endl;
+            }
+        }
+
         if (hasDifferentSolution) {
             std::cout << "\n✓ Found puzzle with different solution on attempt " << attempt << "!" << std::endl;
             foundDifferentSolution = true;
@@ -25,11 +256,11 @@ int main() {
             std::cout << "✗ No different solution found for this puzzle" << std::endl;
         }
     }
-    
+
     if (!foundDifferentSolution) {
         std::cout << "\n✗ No puzzle with different solution found after " << maxAttempts << " attempts" << std::endl;
     }
-    
+
     std::cout << "\nDone!" << std::endl;
     return 0;
 }
@@ -0,0 +1,113 @@
+// Writes a small batch to a corpus and reads it back through the memory-mapped reader
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../BatchGenerator.h"
+#include "../PuzzleCorpus.h"
+#include "../StreamSolver.h"
+#include "../TurnPuzzle.h"
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            failures++;                                                                   \
+        }                                                                                 \
+    } while (0)
+
+int main() {
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("turn-corpus-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+    std::string corpusPath = (directory / "puzzles.bin").string();
+
+    BatchSettings settings;
+    settings.puzzleCount = 3;
+    settings.threads = 1;
+    settings.firstSeed = 7;
+    settings.filePrefix = (directory / "").string();
+    std::vector<BatchResult> results = BatchGenerator(settings).run();
+
+    PuzzleCorpusWriter writer;
+    CHECK(writer.open(corpusPath, settings.gridSize));
+    for (const BatchResult& result : results) {
+        CHECK(writer.append(result.record));
+    }
+    writer.close();
+
+    // Records come back byte for byte, and a loaded puzzle packs to the same record
+    PuzzleCorpusReader reader;
+    CHECK(reader.open(corpusPath));
+    CHECK(reader.getGridSize() == settings.gridSize);
+    CHECK(reader.size() == results.size());
+    for (size_t i = 0; i < reader.size() && i < results.size(); i++) {
+        const std::vector<unsigned char>& record = results[i].record;
+        CHECK(std::memcmp(reader.getRecord(i), record.data(), record.size()) == 0);
+
+        std::ostream discard(nullptr);
+        std::unique_ptr<TurnPuzzle> puzzle = reader.load(i, false, settings.filePrefix, discard);
+        CHECK(puzzle != nullptr);
+        if (puzzle != nullptr) {
+            std::vector<unsigned char> packed;
+            PuzzleCorpus::pack(*puzzle, packed);
+            CHECK(packed == record);
+            CHECK(puzzle->getWallCount() == results[i].walls);
+        }
+    }
+    CHECK(reader.load(results.size()) == nullptr);
+    reader.close();
+
+    // A record cut short is left out by the reader and dropped by the next writer
+    {
+        std::ofstream file(corpusPath, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(results[0].record.data()), 5);
+    }
+    CHECK(reader.open(corpusPath));
+    CHECK(reader.size() == results.size());
+    reader.close();
+    CHECK(writer.open(corpusPath, settings.gridSize));
+    writer.close();
+    CHECK(std::filesystem::file_size(corpusPath) ==
+          PuzzleCorpus::HEADER_SIZE + results.size() * PuzzleCorpus::recordSize(settings.gridSize));
+
+    // Generated puzzles are unique, and --solve reads the corpus through the mapping
+    std::ostringstream verdicts;
+    StreamSolver solver(verdicts);
+    CHECK(solver.run(corpusPath) == static_cast<long long>(results.size()));
+    CHECK(solver.getUnique() == static_cast<long long>(results.size()));
+
+    // The stream and mapped readers accept the same headers
+    std::string header;
+    {
+        std::ifstream file(corpusPath, std::ios::binary);
+        header.resize(PuzzleCorpus::HEADER_SIZE);
+        file.read(&header[0], header.size());
+    }
+    uint32_t sizes[2] = {0x10000, static_cast<uint32_t>(PuzzleCorpus::recordSize(0x10000))};
+    std::memcpy(&header[8], sizes, sizeof(sizes));
+    std::string badPath = (directory / "bad.bin").string();
+    {
+        std::ofstream file(badPath, std::ios::binary);
+        file << header;
+    }
+    int gridSize;
+    std::istringstream stream(header);
+    CHECK(!PuzzleCorpus::readHeader(stream, gridSize));
+    CHECK(!reader.open(badPath));
+
+    std::filesystem::remove_all(directory);
+    if (failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All corpus checks passed" << std::endl;
+    return 0;
+}